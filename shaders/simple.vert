@@ -1,19 +1,60 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 proj;
+// frame-enkent egyszer irodik, a binding-ok a RenderState-ben vannak
+layout(std140, binding = 0) uniform FrameUniforms {
+    mat4 view;
+    mat4 proj;
+};
 
+#ifdef USE_MULTI_DRAW
+// a MultiDrawRenderer batch-enkent koti, a gl_DrawIDARB a batch-en beluli index
+struct DrawData {
+    mat4 model;
+    vec4 posOffset;
+    vec4 posScale;
+};
+
+layout(std430, binding = 0) readonly buffer DrawBuffer {
+    DrawData draws[];
+};
+#else
+// mesh-enkent egy szelet a uniform ringben
+layout(std140, binding = 1) uniform ObjectUniforms {
+    mat4 model;
+    // packed vertex eseten a pozicio unorm16 a mesh befoglalo dobozaban, kulonben offset = 0, scale = 1
+    vec4 posOffset;
+    vec4 posScale;
+};
+#endif
+
+// a HAS_<STREAM> define-okat a GpuProgram szurja be a mesh vertex stream-jei alapjan
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inColor;
+#ifdef HAS_UV
 layout(location = 2) in vec2 inTexCoord;
+#endif
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
 
 void main() {
-    gl_Position = proj * view * model * vec4(inPosition, 1.0);
-    fragColor = inColor;
+#ifdef USE_MULTI_DRAW
+    DrawData draw = draws[gl_DrawIDARB];
+    mat4 objectModel = draw.model;
+    vec3 objectOffset = draw.posOffset.xyz;
+    vec3 objectScale = draw.posScale.xyz;
+#else
+    mat4 objectModel = model;
+    vec3 objectOffset = posOffset.xyz;
+    vec3 objectScale = posScale.xyz;
+#endif
+
+    vec3 position = objectOffset + inPosition * objectScale;
+    gl_Position = proj * view * objectModel * vec4(position, 1.0);
+    fragColor = vec3(1.0);
+#ifdef HAS_UV
     fragTexCoord = inTexCoord;
+#else
+    fragTexCoord = vec2(0.0);
+#endif
 }
@@ -1,6 +1,7 @@
 #include "app.h"
 
 #include "runcfg.h"
+#include "image_cache.h"
 
 App::App(Utils::WindowSize windowSize) :
 	windowSize{ windowSize }
@@ -23,6 +24,8 @@ void App::run()
 void App::initRuncfg()
 {
 	theRuncfg.Init();
+	theImageCache.SetBudget(theRuncfg.imageCacheBudget);
+	theImageCache.SetDiskCacheEnabled(theRuncfg.imageDiskCache);
 
 	if (theRuncfg.currentRenderer == "vk") renderer = Renderer::VK;
 	if (theRuncfg.currentRenderer == "gl") renderer = Renderer::GL;
@@ -0,0 +1,79 @@
+#include "block_texture.h"
+
+#include "gl_wrapper.h"
+
+BlockTexture::BlockTexture(BlockTextureSet const& textureSet, GLuint textureUnit) :
+	texture{ 0, textureUnit },
+	target{ textureSet.layout == BlockTextureSet::Layout::ARRAY ? GLenum(GL_TEXTURE_2D_ARRAY) : GLenum(GL_TEXTURE_2D) }
+{
+	auto levelCount = static_cast<GLsizei>(textureSet.GetLevelCount());
+	auto layerCount = static_cast<GLsizei>(textureSet.layers.size());
+
+	glGenTextures(1, &texture.handle);
+	glBindTexture(target, texture.handle);
+
+	if (target == GL_TEXTURE_2D_ARRAY) {
+		glTexStorage3D(target, levelCount, GL_RGBA8, textureSet.size.x, textureSet.size.y, layerCount);
+	}
+	else {
+		glTexStorage2D(target, levelCount, GL_RGBA8, textureSet.size.x, textureSet.size.y);
+	}
+
+	// minden reteg minden szintje egyetlen pixel unpack buffer-be kerul, a feltoltes onnan tortenik
+	GLuint uploadBuffer;
+	glGenBuffers(1, &uploadBuffer);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBuffer);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)textureSet.GetSizeBytes(), nullptr, GL_STREAM_DRAW);
+
+	auto uploadPtr = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)textureSet.GetSizeBytes(), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+	size_t uploadOffset = 0;
+	for (auto const& layer : textureSet.layers) {
+		for (auto const& level : layer) {
+			std::memcpy(uploadPtr + uploadOffset, level.pixels.data(), level.pixels.size());
+			uploadOffset += level.pixels.size();
+		}
+	}
+	glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+	uploadOffset = 0;
+	for (GLsizei layerIdx = 0; layerIdx < layerCount; layerIdx++) {
+		for (GLsizei levelIdx = 0; levelIdx < levelCount; levelIdx++) {
+			auto const& level = textureSet.layers[layerIdx][levelIdx];
+			auto pixels = reinterpret_cast<void const*>(uploadOffset);
+
+			if (target == GL_TEXTURE_2D_ARRAY) {
+				glTexSubImage3D(target, levelIdx, 0, 0, layerIdx, level.size.x, level.size.y, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+			}
+			else {
+				glTexSubImage2D(target, levelIdx, 0, 0, level.size.x, level.size.y, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+			}
+
+			uploadOffset += level.pixels.size();
+		}
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glDeleteBuffers(1, &uploadBuffer);
+
+	// az atlasz tile-jai a keret miatt a cellan belul ismetlodnek, a teljes atlaszt nem kell korbeerni
+	auto wrapMode = target == GL_TEXTURE_2D_ARRAY ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+	glTexParameteri(target, GL_TEXTURE_WRAP_S, wrapMode);
+	glTexParameteri(target, GL_TEXTURE_WRAP_T, wrapMode);
+
+	// Blocky look when magnifying, trilinear when minifying
+	glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+}
+
+GLuint BlockTexture::GetHandle() const
+{
+	return texture.handle;
+}
+
+void BlockTexture::SetUniform(UniformHandle<int> uniform, GpuProgram const& gpuProgram) const
+{
+	GlWrapper::SetUniform(static_cast<int>(texture.unit), uniform, gpuProgram);
+
+	glActiveTexture(GL_TEXTURE0 + texture.unit);
+	glBindTexture(target, texture.handle);
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "../pch.h"
+
+#include "../texture_packer.h"
+#include "gl_gpu_program.h"
+
+// The packed block textures as one GL texture: GL_TEXTURE_2D_ARRAY or an atlas in a GL_TEXTURE_2D
+struct BlockTexture
+{
+	struct { GLuint handle, unit; } texture;
+	GLenum target;
+
+	// Uploads every layer and level of the set in one transfer
+	BlockTexture(BlockTextureSet const& textureSet, GLuint textureUnit);
+	~BlockTexture() = default;
+
+	GLuint GetHandle() const;
+	// One binding for everything drawn with the set
+	void SetUniform(UniformHandle<int> uniform, GpuProgram const& gpuProgram) const;
+};
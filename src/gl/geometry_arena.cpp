@@ -0,0 +1,223 @@
+#include "geometry_arena.h"
+
+// az indexek uint16 es uint32 tipusuak is lehetnek ugyanabban a bufferben
+static constexpr size_t indexAlignment = 4;
+
+void VertexFormat::Apply(GLuint vao) const
+{
+	for (auto const& attribute : attributes) {
+		glEnableVertexArrayAttrib(vao, attribute.location);
+		glVertexArrayAttribFormat(vao, attribute.location, attribute.componentCount, attribute.type, attribute.normalized, attribute.offset);
+		glVertexArrayAttribBinding(vao, attribute.location, 0);
+	}
+}
+
+FreeListAllocator::FreeListAllocator(size_t capacity) :
+	capacity{ capacity },
+	usedBytes{ 0 }
+{
+	if (capacity > 0) freeRanges.emplace(0, capacity);
+}
+
+std::optional<size_t> FreeListAllocator::Allocate(size_t size, size_t alignment)
+{
+	// egy ures mesh nem foglal helyet, es nem is darabolja a szabad tartomanyt
+	if (size == 0) return 0;
+
+	for (auto it = freeRanges.begin(); it != freeRanges.end(); it++) {
+		auto [rangeOffset, rangeSize] = *it;
+		auto rangeEnd = rangeOffset + rangeSize;
+
+		auto offset = (rangeOffset + alignment - 1) / alignment * alignment;
+		if (offset + size > rangeEnd) continue;
+
+		// az igazitas elotti es az utana maradt resz szabad marad
+		freeRanges.erase(it);
+		if (offset > rangeOffset) freeRanges.emplace(rangeOffset, offset - rangeOffset);
+		if (offset + size < rangeEnd) freeRanges.emplace(offset + size, rangeEnd - offset - size);
+
+		usedBytes += size;
+		return offset;
+	}
+
+	return std::nullopt;
+}
+
+void FreeListAllocator::Free(size_t offset, size_t size)
+{
+	if (size == 0) return;
+
+	usedBytes -= size;
+
+	auto next = freeRanges.lower_bound(offset);
+	auto end = offset + size;
+
+	// osszevonas a kovetkezovel
+	if (next != freeRanges.end() && next->first == end) {
+		end += next->second;
+		next = freeRanges.erase(next);
+	}
+
+	// osszevonas az elozovel
+	if (next != freeRanges.begin()) {
+		auto prev = std::prev(next);
+		if (prev->first + prev->second == offset) {
+			prev->second = end - prev->first;
+			return;
+		}
+	}
+
+	freeRanges.emplace_hint(next, offset, end - offset);
+}
+
+size_t FreeListAllocator::GetCapacity() const
+{
+	return capacity;
+}
+
+size_t FreeListAllocator::GetUsedBytes() const
+{
+	return usedBytes;
+}
+
+size_t FreeListAllocator::GetLargestFreeRange() const
+{
+	size_t largest = 0;
+	for (auto const& [offset, size] : freeRanges) {
+		largest = std::max(largest, size);
+	}
+
+	return largest;
+}
+
+size_t FreeListAllocator::GetFreeRangeCount() const
+{
+	return freeRanges.size();
+}
+
+GeometryArena& GeometryArena::Instance()
+{
+	static GeometryArena instance;
+	return instance;
+}
+
+GeometryAllocation GeometryArena::Allocate(VertexFormat const& format, void const* vertices, size_t vertexBytes, void const* indices, size_t indexBytes)
+{
+	if (format.stride == 0) throw std::runtime_error("vertex format without attributes");
+
+	// a vertex offset a stride tobbszorose, igy a base vertex egesz szam
+	auto tryAllocate = [&](uint32_t pageIdx) -> std::optional<GeometryAllocation> {
+		auto& page = pages[pageIdx];
+		if (page.format != format) return std::nullopt;
+
+		auto vertexOffset = page.vertexRanges.Allocate(vertexBytes, format.stride);
+		if (!vertexOffset) return std::nullopt;
+
+		auto indexOffset = page.indexRanges.Allocate(indexBytes, indexAlignment);
+		if (!indexOffset) {
+			page.vertexRanges.Free(*vertexOffset, vertexBytes);
+			return std::nullopt;
+		}
+
+		page.allocationCount++;
+		return GeometryAllocation{ pageIdx, *vertexOffset, vertexBytes, *indexOffset, indexBytes, (GLint)(*vertexOffset / format.stride) };
+	};
+
+	std::optional<GeometryAllocation> allocation;
+	for (uint32_t pageIdx = 0; pageIdx < pages.size() && !allocation; pageIdx++) {
+		allocation = tryAllocate(pageIdx);
+	}
+
+	if (!allocation) {
+		// a lapnal nagyobb mesh sajat lapot kap
+		auto pageIdx = CreatePage(format, std::max(vertexPageBytes, vertexBytes + format.stride), std::max(indexPageBytes, indexBytes + indexAlignment));
+		allocation = tryAllocate(pageIdx);
+		if (!allocation) throw std::runtime_error("geometry arena allocation failed");
+	}
+
+	auto const& page = pages[allocation->page];
+	if (vertexBytes > 0) glNamedBufferSubData(page.vertexBuffer, (GLintptr)allocation->vertexOffset, (GLsizeiptr)vertexBytes, vertices);
+	if (indexBytes > 0) glNamedBufferSubData(page.indexBuffer, (GLintptr)allocation->indexOffset, (GLsizeiptr)indexBytes, indices);
+
+	return *allocation;
+}
+
+void GeometryArena::Free(GeometryAllocation const& allocation)
+{
+	auto& page = pages[allocation.page];
+	page.vertexRanges.Free(allocation.vertexOffset, allocation.vertexBytes);
+	page.indexRanges.Free(allocation.indexOffset, allocation.indexBytes);
+	page.allocationCount--;
+}
+
+void GeometryArena::Release()
+{
+	for (auto const& page : pages) {
+		std::array<GLuint, 2> buffers = { page.vertexBuffer, page.indexBuffer };
+		glDeleteBuffers((int)buffers.size(), buffers.data());
+		glDeleteVertexArrays(1, &page.vao);
+	}
+
+	pages.clear();
+}
+
+GLuint GeometryArena::GetVao(uint32_t page) const
+{
+	return pages[page].vao;
+}
+
+uint32_t GeometryArena::CreatePage(VertexFormat const& format, size_t vertexBytes, size_t indexBytes)
+{
+	auto& page = pages.emplace_back(Page{ format, 0, 0, 0, FreeListAllocator(vertexBytes), FreeListAllocator(indexBytes), 0 });
+
+	std::array<GLuint, 2> buffers;
+	glCreateBuffers((int)buffers.size(), buffers.data());
+	page.vertexBuffer = buffers[0];
+	page.indexBuffer = buffers[1];
+
+	// immutable, a mesh-ek a glNamedBufferSubData-val kerulnek bele
+	glNamedBufferStorage(page.vertexBuffer, (GLsizeiptr)vertexBytes, nullptr, GL_DYNAMIC_STORAGE_BIT);
+	glNamedBufferStorage(page.indexBuffer, (GLsizeiptr)indexBytes, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+	glCreateVertexArrays(1, &page.vao);
+	glVertexArrayVertexBuffer(page.vao, 0, page.vertexBuffer, 0, (GLsizei)format.stride);
+	glVertexArrayElementBuffer(page.vao, page.indexBuffer);
+	format.Apply(page.vao);
+
+	theLogger.LogInfo("Geometry arena page {} created: {:.1f} MB vertices (stride {}), {:.1f} MB indices",
+		pages.size() - 1, vertexBytes / (1024.0 * 1024.0), format.stride, indexBytes / (1024.0 * 1024.0));
+
+	return (uint32_t)(pages.size() - 1);
+}
+
+GeometryArena::Stats GeometryArena::GetStats() const
+{
+	Stats stats;
+	stats.pageCount = pages.size();
+
+	auto getFragmentation = [](FreeListAllocator const& ranges) {
+		auto freeBytes = ranges.GetCapacity() - ranges.GetUsedBytes();
+		return freeBytes == 0 ? 0.0 : 1.0 - (double)ranges.GetLargestFreeRange() / (double)freeBytes;
+	};
+
+	for (auto const& page : pages) {
+		stats.allocationCount += page.allocationCount;
+		stats.vertexCapacity += page.vertexRanges.GetCapacity();
+		stats.vertexUsed += page.vertexRanges.GetUsedBytes();
+		stats.indexCapacity += page.indexRanges.GetCapacity();
+		stats.indexUsed += page.indexRanges.GetUsedBytes();
+		stats.freeRangeCount += page.vertexRanges.GetFreeRangeCount() + page.indexRanges.GetFreeRangeCount();
+		stats.fragmentation = std::max({ stats.fragmentation, getFragmentation(page.vertexRanges), getFragmentation(page.indexRanges) });
+	}
+
+	return stats;
+}
+
+void GeometryArena::LogStats() const
+{
+	auto stats = GetStats();
+	auto toMB = [](size_t bytes) { return bytes / (1024.0 * 1024.0); };
+	theLogger.LogInfo("Geometry arena: {} meshes in {} pages, vertices {:.1f} of {:.1f} MB, indices {:.1f} of {:.1f} MB, {} free ranges, fragmentation {:.1f}%",
+		stats.allocationCount, stats.pageCount, toMB(stats.vertexUsed), toMB(stats.vertexCapacity),
+		toMB(stats.indexUsed), toMB(stats.indexCapacity), stats.freeRangeCount, stats.fragmentation * 100.0);
+}
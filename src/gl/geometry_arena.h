@@ -0,0 +1,117 @@
+#pragma once
+#include "../pch.h"
+
+// One attribute of an interleaved vertex
+struct VertexAttribute
+{
+	GLuint location;
+	int componentCount;
+	GLenum type;
+	GLboolean normalized;
+	GLuint offset;
+
+	bool operator==(VertexAttribute const& other) const = default;
+};
+
+// The layout of an interleaved vertex buffer, meshes with the same format can share a VAO
+struct VertexFormat
+{
+	std::vector<VertexAttribute> attributes;
+	GLuint stride = 0;
+
+	bool operator==(VertexFormat const& other) const = default;
+
+	// Points the attributes at binding 0 of the VAO
+	void Apply(GLuint vao) const;
+};
+
+// First fit sub-allocator over a range of bytes, the free ranges are merged on Free
+struct FreeListAllocator
+{
+	explicit FreeListAllocator(size_t capacity);
+
+	// The offset is a multiple of alignment, which does not have to be a power of two
+	std::optional<size_t> Allocate(size_t size, size_t alignment);
+	void Free(size_t offset, size_t size);
+
+	size_t GetCapacity() const;
+	size_t GetUsedBytes() const;
+	size_t GetLargestFreeRange() const;
+	size_t GetFreeRangeCount() const;
+
+private:
+	size_t capacity;
+	size_t usedBytes;
+	// offset -> size
+	std::map<size_t, size_t> freeRanges;
+};
+
+// Where a mesh lives in the arena, the draw uses indexOffset and baseVertex with the VAO of the page
+struct GeometryAllocation
+{
+	uint32_t page;
+	size_t vertexOffset;
+	size_t vertexBytes;
+	size_t indexOffset;
+	size_t indexBytes;
+	GLint baseVertex;
+};
+
+// A few large immutable vertex / index buffers shared by the meshes, one VAO per page, so drawing
+// the meshes of a page needs no VAO switch. A page only holds one vertex format, a full page gets a new one.
+struct GeometryArena
+{
+	struct Stats
+	{
+		size_t pageCount = 0;
+		size_t allocationCount = 0;
+		size_t vertexCapacity = 0;
+		size_t vertexUsed = 0;
+		size_t indexCapacity = 0;
+		size_t indexUsed = 0;
+		size_t freeRangeCount = 0;
+		// 1 - the largest free range / all free bytes, of the worst page
+		double fragmentation = 0.0;
+	};
+
+	static constexpr size_t vertexPageBytes = size_t{ 64 } * 1024 * 1024;
+	static constexpr size_t indexPageBytes = size_t{ 32 } * 1024 * 1024;
+
+	static GeometryArena& Instance();
+
+	GeometryArena(GeometryArena const&) = delete;
+	GeometryArena& operator=(GeometryArena const&) = delete;
+	GeometryArena(GeometryArena&&) = delete;
+	GeometryArena& operator=(GeometryArena&&) = delete;
+
+	// Copies the data into the first page of the format with enough room
+	GeometryAllocation Allocate(VertexFormat const& format, void const* vertices, size_t vertexBytes, void const* indices, size_t indexBytes);
+	void Free(GeometryAllocation const& allocation);
+	// Deletes the buffers and VAOs of every page, the allocations handed out become invalid; needs the GL context
+	void Release();
+
+	GLuint GetVao(uint32_t page) const;
+
+	Stats GetStats() const;
+	void LogStats() const;
+
+private:
+	struct Page
+	{
+		VertexFormat format;
+		GLuint vao;
+		GLuint vertexBuffer;
+		GLuint indexBuffer;
+		FreeListAllocator vertexRanges;
+		FreeListAllocator indexRanges;
+		size_t allocationCount;
+	};
+
+	std::vector<Page> pages;
+
+	GeometryArena() = default;
+
+	uint32_t CreatePage(VertexFormat const& format, size_t vertexBytes, size_t indexBytes);
+};
+
+inline GeometryArena& theGeometryArena = GeometryArena::Instance();
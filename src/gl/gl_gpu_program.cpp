@@ -67,7 +67,21 @@ void GpuProgram::CheckLinking(unsigned program)
 	}
 }
 
-GLuint GpuProgram::CompileShader(GLenum shaderType, std::string const& path)
+std::string GpuProgram::InsertDefines(std::string const& shaderSource, std::string const& defines)
+{
+	if (defines.empty()) return shaderSource;
+
+	// a #version-nek kell az elso utasitasnak lennie
+	auto versionPos = shaderSource.find("#version");
+	if (versionPos == std::string::npos) return defines + shaderSource;
+
+	auto lineEnd = shaderSource.find('\n', versionPos);
+	if (lineEnd == std::string::npos) return shaderSource + "\n" + defines;
+
+	return shaderSource.substr(0, lineEnd + 1) + defines + shaderSource.substr(lineEnd + 1);
+}
+
+GLuint GpuProgram::CompileShader(GLenum shaderType, std::string const& path, std::string const& defines)
 {
 	auto shaderHandle = glCreateShader(shaderType);
 
@@ -75,7 +89,7 @@ GLuint GpuProgram::CompileShader(GLenum shaderType, std::string const& path)
 		throw std::runtime_error("Error in vertex shader creation");
 	}
 
-	auto shaderSource = Utils::ReadTextFile(path);
+	auto shaderSource = InsertDefines(Utils::ReadTextFile(path), defines);
 	auto shaderSourcePtr = shaderSource.c_str();
 	glShaderSource(shaderHandle, 1, &shaderSourcePtr, nullptr);
 
@@ -96,7 +110,7 @@ void GpuProgram::Create()
 	{
 		// TODO Check shader type by extension
 		auto resolvedShaderPath = (theRuncfg.shadersDir / shaderPath.path).string();
-		auto shaderHandle = CompileShader(ShaderPath::GetGlType(shaderPath.type), resolvedShaderPath);
+		auto shaderHandle = CompileShader(ShaderPath::GetGlType(shaderPath.type), resolvedShaderPath, shaderDefines);
 		glAttachShader(programHandle, shaderHandle);
 
 		shaderHandleList.push_back(shaderHandle);
@@ -111,9 +125,129 @@ void GpuProgram::Create()
 		glDeleteShader(shaderHandle);
 	}
 
+	ReflectUniforms();
 	PrintActiveNames();
 }
 
+void GpuProgram::ReflectUniforms()
+{
+	uniforms.clear();
+	uniformValues.clear();
+
+	auto uniformLength = GlWrapper::GetProgramiv(programHandle, GL_ACTIVE_UNIFORM_MAX_LENGTH);
+	std::vector<char> name(std::max(uniformLength, 1));
+	int length, size;
+	GLenum type;
+
+	size_t valuesSize = 0;
+	int uniformCount = GlWrapper::GetProgramiv(programHandle, GL_ACTIVE_UNIFORMS);
+	for (int i = 0; i < uniformCount; i++)
+	{
+		glGetActiveUniform(programHandle, (GLuint)i, static_cast<GLsizei>(name.size()), &length, &size, &type, name.data());
+
+		// a uniform block-ok tagjainak nincs location-je, azokat nem glUniform* allitja
+		auto location = glGetUniformLocation(programHandle, name.data());
+		if (location < 0) continue;
+
+		auto& uniform = uniforms.emplace_back();
+		uniform.name = std::string(name.data(), length);
+		if (uniform.name.ends_with("[0]")) uniform.name.resize(uniform.name.size() - 3);
+		uniform.type = type;
+		uniform.arraySize = size;
+		uniform.location = location;
+		uniform.valueOffset = valuesSize;
+		uniform.valueSize = GetUniformTypeSize(type) * size;
+		uniform.hasValue = false;
+
+		valuesSize += uniform.valueSize;
+	}
+
+	// egyszer foglalunk, a setterek mar csak ebbe masolnak
+	uniformValues.resize(valuesSize);
+}
+
+int GpuProgram::FindUniform(std::string const& uniformName, GLenum glType, char const* typeName) const
+{
+	auto it = std::find_if(uniforms.begin(), uniforms.end(), [&](ActiveUniform const& uniform) { return uniform.name == uniformName; });
+	if (it == uniforms.end())
+	{
+		theLogger.LogInfo("[ shader: {} ] uniform({}) {} cannot be set", GetPrettyName(), typeName, uniformName);
+		return -1;
+	}
+
+	auto isCompatible = it->type == glType || (glType == GL_INT && (it->type == GL_BOOL || IsSamplerType(it->type)));
+	if (!isCompatible)
+	{
+		theLogger.LogWarning("[ shader: {} ] uniform({}) {} has a different type in the shader: {}", GetPrettyName(), typeName, uniformName, it->type);
+		return -1;
+	}
+
+	return static_cast<int>(it - uniforms.begin());
+}
+
+GLint GpuProgram::UpdateUniformValue(int uniformIndex, void const* value, size_t sizeBytes) const
+{
+	if (uniformIndex < 0) return -1;
+
+	auto& uniform = uniforms[uniformIndex];
+	if (uniform.valueSize == 0) return uniform.location;
+
+	// a tombnek csak a shaderben is letezo resze szamit
+	auto valueSize = std::min(sizeBytes, uniform.valueSize);
+	auto cachedValue = uniformValues.data() + uniform.valueOffset;
+
+	if (uniform.hasValue && sizeBytes >= uniform.valueSize && std::memcmp(cachedValue, value, valueSize) == 0) return -1;
+
+	std::memcpy(cachedValue, value, valueSize);
+	// egy rovidebb tomb utan a maradek nem ismert
+	uniform.hasValue = sizeBytes >= uniform.valueSize;
+
+	return uniform.location;
+}
+
+bool GpuProgram::IsSamplerType(GLenum type)
+{
+	switch (type)
+	{
+		case GL_SAMPLER_1D:
+		case GL_SAMPLER_2D:
+		case GL_SAMPLER_3D:
+		case GL_SAMPLER_CUBE:
+		case GL_SAMPLER_2D_SHADOW:
+		case GL_SAMPLER_1D_ARRAY:
+		case GL_SAMPLER_2D_ARRAY:
+		case GL_SAMPLER_2D_ARRAY_SHADOW:
+		case GL_SAMPLER_CUBE_SHADOW:
+		case GL_SAMPLER_2D_MULTISAMPLE:
+		case GL_SAMPLER_BUFFER:
+		case GL_INT_SAMPLER_2D:
+		case GL_INT_SAMPLER_2D_ARRAY:
+		case GL_UNSIGNED_INT_SAMPLER_2D:
+		case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+			return true;
+		default:
+			return false;
+	}
+}
+
+size_t GpuProgram::GetUniformTypeSize(GLenum type)
+{
+	if (IsSamplerType(type)) return sizeof(GLint);
+
+	switch (type)
+	{
+		case GL_FLOAT: return sizeof(float);
+		case GL_FLOAT_VEC2: return 2 * sizeof(float);
+		case GL_FLOAT_VEC3: return 3 * sizeof(float);
+		case GL_FLOAT_VEC4: return 4 * sizeof(float);
+		case GL_INT: return sizeof(GLint);
+		case GL_BOOL: return sizeof(GLint);
+		case GL_FLOAT_MAT3: return 9 * sizeof(float);
+		case GL_FLOAT_MAT4: return 16 * sizeof(float);
+		default: return 0;
+	}
+}
+
 void GpuProgram::PrintActiveNames()
 {
 	if (!debugPrintActiveNames) return;
@@ -10,10 +10,43 @@ struct ShaderPath
 	static unsigned GetGlType(Type type);
 };
 
+// The GL type a uniform setter uploads, checked against the reflected type when the handle is resolved
+template<typename T> struct UniformTraits;
+template<> struct UniformTraits<glm::mat4> { static constexpr GLenum glType = GL_FLOAT_MAT4; static constexpr char const* typeName = "mat4"; };
+template<> struct UniformTraits<glm::mat3> { static constexpr GLenum glType = GL_FLOAT_MAT3; static constexpr char const* typeName = "mat3"; };
+template<> struct UniformTraits<glm::vec3> { static constexpr GLenum glType = GL_FLOAT_VEC3; static constexpr char const* typeName = "vec3"; };
+template<> struct UniformTraits<std::vector<glm::mat4>> { static constexpr GLenum glType = GL_FLOAT_MAT4; static constexpr char const* typeName = "vector<mat4>"; };
+template<> struct UniformTraits<float> { static constexpr GLenum glType = GL_FLOAT; static constexpr char const* typeName = "float"; };
+// int also sets bool and sampler uniforms
+template<> struct UniformTraits<int> { static constexpr GLenum glType = GL_INT; static constexpr char const* typeName = "int"; };
+
+// A uniform resolved once by name, the setters use it without any lookup
+template<typename T>
+struct UniformHandle
+{
+	int index = -1;	// into GpuProgram::uniforms, -1 if the program has no such active uniform
+
+	bool IsValid() const { return index >= 0; }
+};
+
+// One active uniform of the linked program, reflected in Create
+struct ActiveUniform
+{
+	std::string name;	// without the [0] of arrays
+	GLenum type;
+	GLint arraySize;
+	GLint location;
+	// the last uploaded value in GpuProgram::uniformValues, 0 bytes if it is not cached
+	size_t valueOffset;
+	size_t valueSize;
+	bool hasValue;
+};
+
 struct GpuProgram
 {
 	GLuint programHandle;
 	std::vector<ShaderPath> shaderPathList;
+	std::string shaderDefines;	// inserted after the #version line of every shader
 
 	GpuProgram();
 	virtual ~GpuProgram();
@@ -21,6 +54,16 @@ struct GpuProgram
 	void Create();
 	void PrintActiveNames();
 
+	// Call after Create, an inactive or mistyped uniform gives an invalid handle and is logged once here
+	template<typename T> UniformHandle<T> GetUniform(std::string const& uniformName) const
+	{
+		return UniformHandle<T>{ FindUniform(uniformName, UniformTraits<T>::glType, UniformTraits<T>::typeName) };
+	}
+
+	// Stores the value as the last upload, returns the location to upload it to,
+	// or -1 if the handle is invalid or the uniform already holds this value
+	GLint UpdateUniformValue(int uniformIndex, void const* value, size_t sizeBytes) const;
+
 	virtual void Bind() const = 0;
 	virtual void BindMaterial() const = 0;
 	virtual std::string GetPrettyName() const = 0;
@@ -28,8 +71,18 @@ struct GpuProgram
 private:
 	bool debugPrintActiveNames;
 
+	// a Bind const, de a feltoltott ertekek nyilvantartasa a programhoz tartozik
+	mutable std::vector<ActiveUniform> uniforms;
+	mutable std::vector<std::byte> uniformValues;
+
+	void ReflectUniforms();
+	int FindUniform(std::string const& uniformName, GLenum glType, char const* typeName) const;
+	static bool IsSamplerType(GLenum type);
+	static size_t GetUniformTypeSize(GLenum type);
+
 	static void GetErrorInfo(unsigned handle);
 	static void CheckShader(unsigned shader, std::string const& message);
 	static void CheckLinking(unsigned program);
-	static GLuint CompileShader(GLenum shaderType, std::string const& path);
+	static GLuint CompileShader(GLenum shaderType, std::string const& path, std::string const& defines);
+	static std::string InsertDefines(std::string const& shaderSource, std::string const& defines);
 };
@@ -1,8 +1,10 @@
 #include "gl_object_3d.h"
 
 #include "../camera.h"
+#include "../runcfg.h"
 #include "gl_gpu_program.h"
 #include "render_state.h"
+#include "../load_report.h"
 
 Transformation::Transformation() :
 	translate{ 0.0f, 0.0f, 0.0f },
@@ -25,13 +27,21 @@ void VertexData::ClearAll()
 	uvs.clear();
 	tangents.clear();
 	bitangents.clear();
+	packedVertices.clear();
 
 	cleared = true;
 }
 
 Mesh::Mesh() :
 	vao{ 0 },
-	indicesCount{ 0 }
+	isPacked{ false },
+	isInterleaved{ false },
+	isInArena{ false },
+	allocation{},
+	indicesCount{ 0 },
+	indexType{ IndexType::UINT32 },
+	boundingCenter{ 0.0f, 0.0f, 0.0f },
+	boundingRadius{ 0.0f }
 {
 }
 
@@ -40,41 +50,178 @@ void Mesh::Init(uint newVao)
 	vao = newVao;
 }
 
-void Mesh::UploadVertices(std::unordered_map<VertexLayout, int>& attribLocations)
+void Mesh::CreateBuffers()
 {
+	// interleaved eseten minden stream a pozicio bufferben van
+	if (isInterleaved) {
+		std::array<uint, 2> bufferList;
+		glCreateBuffers((int)bufferList.size(), bufferList.data());
+
+		vertexHandles[VertexLayout::POSITION] = bufferList[0];
+		vertexHandles[VertexLayout::INDEX] = bufferList[1];
+		return;
+	}
+
+	// packed vertex eseten az uv a pozicio bufferben van
+	std::vector<VertexLayout> layouts;
+	for (auto layout : { VertexLayout::POSITION, VertexLayout::NORMAL, VertexLayout::UV, VertexLayout::TANGENT, VertexLayout::BITANGENT }) {
+		if (!vertexStreams.Has(layout)) continue;
+		if (isPacked && layout == VertexLayout::UV) continue;
+		layouts.push_back(layout);
+	}
+	layouts.push_back(VertexLayout::INDEX);
+
+	std::vector<uint> bufferList;
+	bufferList.resize(layouts.size());
+	glGenBuffers((int)bufferList.size(), bufferList.data());
+
+	for (int i = 0; i < layouts.size(); i++) {
+		vertexHandles[layouts[i]] = bufferList[i];
+	}
+}
+
+size_t Mesh::UploadVertices(std::unordered_map<VertexLayout, int>& attribLocations)
+{
+	if (isInArena) {
+		return UploadToArena(attribLocations);
+	}
+
+	if (isInterleaved) {
+		return UploadInterleaved(attribLocations);
+	}
+
 	// A GLM_FORCE_DEFAULT_ALIGNED_GENTYPES miatt kell, mert ezzel
 	// peldaul a sizeof(glm::vec3) az 16 lesz a megszokott 12 helyett
 	auto vec2ComponentCount = (uint)(sizeof(glm::vec2) / sizeof(float));
 	auto vec3ComponentCount = (uint)(sizeof(glm::vec3) / sizeof(float));
 	auto vec4ComponentCount = (uint)(sizeof(glm::vec4) / sizeof(float));
 
-	glBindBuffer(GL_ARRAY_BUFFER, vertexHandles[VertexLayout::POSITION]);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * vertexData.vertexCount, vertexData.positions.data(), GL_STATIC_DRAW);
-	glEnableVertexAttribArray(attribLocations[VertexLayout::POSITION]);
-	glVertexAttribPointer(attribLocations[VertexLayout::POSITION], vec3ComponentCount, GL_FLOAT, GL_FALSE, 0, nullptr);
+	size_t uploadedBytes = 0;
 
-	glBindBuffer(GL_ARRAY_BUFFER, vertexHandles[VertexLayout::NORMAL]);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * vertexData.vertexCount, vertexData.normals.data(), GL_STATIC_DRAW);
-	glEnableVertexAttribArray(attribLocations[VertexLayout::NORMAL]);
-	glVertexAttribPointer(attribLocations[VertexLayout::NORMAL], vec3ComponentCount, GL_FLOAT, GL_FALSE, 0, nullptr);
+	// a hianyzo stream-ek attributuma kikapcsolva marad, nem kap buffert
+	auto uploadStream = [&](VertexLayout layout, void const* data, size_t elementSize, uint componentCount) {
+		if (!vertexStreams.Has(layout)) return;
 
-	glBindBuffer(GL_ARRAY_BUFFER, vertexHandles[VertexLayout::UV]);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec2) * vertexData.vertexCount, vertexData.uvs.data(), GL_STATIC_DRAW);
-	glEnableVertexAttribArray(attribLocations[VertexLayout::UV]);
-	glVertexAttribPointer(attribLocations[VertexLayout::UV], vec2ComponentCount, GL_FLOAT, GL_FALSE, 0, nullptr);
+		glBindBuffer(GL_ARRAY_BUFFER, vertexHandles[layout]);
+		glBufferData(GL_ARRAY_BUFFER, elementSize * vertexData.vertexCount, data, GL_STATIC_DRAW);
+		uploadedBytes += elementSize * vertexData.vertexCount;
+		glEnableVertexAttribArray(attribLocations[layout]);
+		glVertexAttribPointer(attribLocations[layout], componentCount, GL_FLOAT, GL_FALSE, 0, nullptr);
+	};
 
-	glBindBuffer(GL_ARRAY_BUFFER, vertexHandles[VertexLayout::TANGENT]);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * vertexData.vertexCount, vertexData.tangents.data(), GL_STATIC_DRAW);
-	glEnableVertexAttribArray(attribLocations[VertexLayout::TANGENT]);
-	glVertexAttribPointer(attribLocations[VertexLayout::TANGENT], vec3ComponentCount, GL_FLOAT, GL_FALSE, 0, nullptr);
+	if (isPacked) {
+		// a pozicio es az uv egy bufferben, a pozicio unorm16 a mesh befoglalo dobozahoz kepest, az uv half float
+		auto stride = (int)sizeof(PackedVertex);
+
+		glBindBuffer(GL_ARRAY_BUFFER, vertexHandles[VertexLayout::POSITION]);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(PackedVertex) * vertexData.vertexCount, vertexData.packedVertices.data(), GL_STATIC_DRAW);
+		uploadedBytes += sizeof(PackedVertex) * vertexData.vertexCount;
+		glEnableVertexAttribArray(attribLocations[VertexLayout::POSITION]);
+		glVertexAttribPointer(attribLocations[VertexLayout::POSITION], 4, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)offsetof(PackedVertex, pos));
+		glEnableVertexAttribArray(attribLocations[VertexLayout::UV]);
+		glVertexAttribPointer(attribLocations[VertexLayout::UV], 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(PackedVertex, texCoord));
+	}
+	else {
+		uploadStream(VertexLayout::POSITION, vertexData.positions.data(), sizeof(glm::vec3), vec3ComponentCount);
+		uploadStream(VertexLayout::UV, vertexData.uvs.data(), sizeof(glm::vec2), vec2ComponentCount);
+	}
 
-	glBindBuffer(GL_ARRAY_BUFFER, vertexHandles[VertexLayout::BITANGENT]);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * vertexData.vertexCount, vertexData.bitangents.data(), GL_STATIC_DRAW);
-	glEnableVertexAttribArray(attribLocations[VertexLayout::BITANGENT]);
-	glVertexAttribPointer(attribLocations[VertexLayout::BITANGENT], vec3ComponentCount, GL_FLOAT, GL_FALSE, 0, nullptr);
+	uploadStream(VertexLayout::NORMAL, vertexData.normals.data(), sizeof(glm::vec3), vec3ComponentCount);
+	uploadStream(VertexLayout::TANGENT, vertexData.tangents.data(), sizeof(glm::vec3), vec3ComponentCount);
+	uploadStream(VertexLayout::BITANGENT, vertexData.bitangents.data(), sizeof(glm::vec3), vec3ComponentCount);
 
+	auto packedIndices = VertexPacker::PackIndices(indices, indexType);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vertexHandles[VertexLayout::INDEX]);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint) * indicesCount, indices.data(), GL_STATIC_DRAW);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, packedIndices.size(), packedIndices.data(), GL_STATIC_DRAW);
+	uploadedBytes += packedIndices.size();
+
+	return uploadedBytes;
+}
+
+std::vector<uint8_t> Mesh::BuildInterleavedVertices(std::unordered_map<VertexLayout, int>& attribLocations, VertexFormat& format) const
+{
+	struct InterleavedStream
+	{
+		uint8_t const* data;
+		size_t sourceStride;
+		size_t offset;
+		size_t byteCount;
+	};
+
+	std::vector<InterleavedStream> streams;
+	format = VertexFormat{};
+
+	auto addAttribute = [&](VertexLayout layout, int componentCount, GLenum type, GLboolean normalized, GLuint offset) {
+		format.attributes.push_back(VertexAttribute{ (GLuint)attribLocations[layout], componentCount, type, normalized, offset });
+	};
+
+	// a forras stride-ja a glm tipus merete (ami igazitott is lehet), a bufferben szorosan kovetik egymast
+	auto addStream = [&](VertexLayout layout, void const* data, size_t sourceStride, int componentCount) {
+		if (!vertexStreams.Has(layout)) return;
+
+		auto byteCount = sizeof(float) * componentCount;
+		streams.push_back(InterleavedStream{ static_cast<uint8_t const*>(data), sourceStride, format.stride, byteCount });
+		addAttribute(layout, componentCount, GL_FLOAT, GL_FALSE, format.stride);
+		format.stride += (GLuint)byteCount;
+	};
+
+	if (isPacked) {
+		// a PackedVertex mar interleaved, a tobbi stream utana kovetkezik
+		streams.push_back(InterleavedStream{ reinterpret_cast<uint8_t const*>(vertexData.packedVertices.data()), sizeof(PackedVertex), 0, sizeof(PackedVertex) });
+		addAttribute(VertexLayout::POSITION, 4, GL_UNSIGNED_SHORT, GL_TRUE, (GLuint)offsetof(PackedVertex, pos));
+		addAttribute(VertexLayout::UV, 2, GL_HALF_FLOAT, GL_FALSE, (GLuint)offsetof(PackedVertex, texCoord));
+		format.stride = sizeof(PackedVertex);
+	}
+	else {
+		addStream(VertexLayout::POSITION, vertexData.positions.data(), sizeof(glm::vec3), 3);
+		addStream(VertexLayout::UV, vertexData.uvs.data(), sizeof(glm::vec2), 2);
+	}
+
+	addStream(VertexLayout::NORMAL, vertexData.normals.data(), sizeof(glm::vec3), 3);
+	addStream(VertexLayout::TANGENT, vertexData.tangents.data(), sizeof(glm::vec3), 3);
+	addStream(VertexLayout::BITANGENT, vertexData.bitangents.data(), sizeof(glm::vec3), 3);
+
+	std::vector<uint8_t> vertices(size_t{ format.stride } * vertexData.vertexCount);
+	for (size_t vertexIdx = 0; vertexIdx < (size_t)vertexData.vertexCount; vertexIdx++) {
+		auto vertex = vertices.data() + format.stride * vertexIdx;
+		for (auto const& stream : streams) {
+			std::memcpy(vertex + stream.offset, stream.data + stream.sourceStride * vertexIdx, stream.byteCount);
+		}
+	}
+
+	return vertices;
+}
+
+size_t Mesh::UploadInterleaved(std::unordered_map<VertexLayout, int>& attribLocations)
+{
+	VertexFormat format;
+	auto vertices = BuildInterleavedVertices(attribLocations, format);
+	auto packedIndices = VertexPacker::PackIndices(indices, indexType);
+
+	auto vertexBuffer = (GLuint)vertexHandles[VertexLayout::POSITION];
+	auto indexBuffer = (GLuint)vertexHandles[VertexLayout::INDEX];
+
+	// ures storage-et nem lehet letrehozni, egy ures mesh-nek nem is kell
+	if (!vertices.empty()) glNamedBufferStorage(vertexBuffer, vertices.size(), vertices.data(), 0);
+	if (!packedIndices.empty()) glNamedBufferStorage(indexBuffer, packedIndices.size(), packedIndices.data(), 0);
+
+	glVertexArrayVertexBuffer(vao, 0, vertexBuffer, 0, (GLsizei)format.stride);
+	glVertexArrayElementBuffer(vao, indexBuffer);
+	format.Apply(vao);
+
+	return vertices.size() + packedIndices.size();
+}
+
+size_t Mesh::UploadToArena(std::unordered_map<VertexLayout, int>& attribLocations)
+{
+	VertexFormat format;
+	auto vertices = BuildInterleavedVertices(attribLocations, format);
+	auto packedIndices = VertexPacker::PackIndices(indices, indexType);
+
+	allocation = theGeometryArena.Allocate(format, vertices.data(), vertices.size(), packedIndices.data(), packedIndices.size());
+	vao = theGeometryArena.GetVao(allocation.page);
+
+	return vertices.size() + packedIndices.size();
 }
 
 void Object3D::Draw(GpuProgram const& gpuProgram, Camera const& camera) const
@@ -84,28 +231,86 @@ void Object3D::Draw(GpuProgram const& gpuProgram, Camera const& camera) const
 	auto currentTime = std::chrono::high_resolution_clock::now();
 	float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
 
-	glm::mat4 identity{ 1.0f };
-	auto const& translate = glm::translate(animatedTransformation.translate);
-	auto const& rotate = glm::rotate(identity, animatedTransformation.rotate, animatedTransformation.rotationAxis);
-	auto const& scale = glm::scale(animatedTransformation.scale);
-
-	theRenderState.model = translate * rotate * scale;
-	theRenderState.view = camera.V();
-	theRenderState.proj = camera.P();
+	theRenderState.model = GetModelMatrix();
 
 	gpuProgram.Bind();
 
+	// az arena mesh-ei egy VAO-n osztoznak, csak lapvaltaskor kell kotni
+	GLuint boundVao = 0;
+
 	for (auto const& mesh : meshes)
 	{
 		theRenderState.surfaceTexture = mesh.surfaceTexture.get();
+		theRenderState.posOffset = mesh.quantization.offset;
+		theRenderState.posScale = mesh.quantization.scale;
 		gpuProgram.BindMaterial();
 
-		glBindVertexArray(mesh.vao);
-		glDrawElements(GL_TRIANGLES, mesh.indicesCount, GL_UNSIGNED_INT, nullptr);
+		auto const& lod = SelectLod(mesh, theRenderState.model, camera);
+		auto indexType = mesh.indexType == IndexType::UINT16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+		auto indexOffset = VertexPacker::IndexSize(mesh.indexType) * lod.indexOffset;
+
+		if (mesh.vao != boundVao) {
+			glBindVertexArray(mesh.vao);
+			boundVao = mesh.vao;
+		}
+
+		if (mesh.isInArena) {
+			glDrawElementsBaseVertex(GL_TRIANGLES, lod.indexCount, indexType, (void*)(mesh.allocation.indexOffset + indexOffset), mesh.allocation.baseVertex);
+		}
+		else {
+			glDrawElements(GL_TRIANGLES, lod.indexCount, indexType, (void*)indexOffset);
+		}
+	}
+}
+
+void Object3D::CollectDraws(Camera const& camera, std::vector<MeshDraw>& draws) const
+{
+	auto model = GetModelMatrix();
+
+	for (auto const& mesh : meshes) {
+		draws.push_back(MeshDraw{ &mesh, &SelectLod(mesh, model, camera), model });
+	}
+}
+
+glm::mat4 Object3D::GetModelMatrix() const
+{
+	glm::mat4 identity{ 1.0f };
+	auto const& translate = glm::translate(animatedTransformation.translate);
+	auto const& rotate = glm::rotate(identity, animatedTransformation.rotate, animatedTransformation.rotationAxis);
+	auto const& scale = glm::scale(animatedTransformation.scale);
+
+	return translate * rotate * scale;
+}
+
+MeshLod const& Object3D::SelectLod(Mesh const& mesh, glm::mat4 const& model, Camera const& camera) const
+{
+	// a befoglalo gomb kamerahoz legkozelebbi pontjaban egy egysegnyi hossz ennyi pixel
+	auto const& scale = animatedTransformation.scale;
+	auto maxScale = std::max({ std::abs(scale.x), std::abs(scale.y), std::abs(scale.z) });
+
+	auto viewCenter = camera.V() * model * glm::vec4(mesh.boundingCenter, 1.0f);
+	auto distance = std::max(glm::length(glm::vec3(viewCenter)) - mesh.boundingRadius * maxScale, camera.parameters.clippingDistance.zNear);
+	auto pixelsPerUnit = camera.P()[1][1] * camera.parameters.windowSize.y * 0.5f / distance;
+
+	// a legdurvabb szint, aminek a hibaja meg nem lathato
+	for (auto i = (int)mesh.lods.size() - 1; i > 0; i--) {
+		if (mesh.lods[i].error * maxScale * pixelsPerUnit <= lodPixelError) {
+			return mesh.lods[i];
+		}
 	}
+
+	return mesh.lods[0];
 }
 
 void Object3D::Create(LoadedModel const& loadedModel)
+{
+	for (int i = 0; i < loadedModel.shapes.size(); i++)
+	{
+		CreateMesh(loadedModel, i);
+	}
+}
+
+void Object3D::CreateMesh(LoadedModel const& loadedModel, size_t shapeIdx)
 {
 	static std::unordered_map<VertexLayout, int> attribLocations = {
 		{ VertexLayout::POSITION, 0 },
@@ -115,50 +320,102 @@ void Object3D::Create(LoadedModel const& loadedModel)
 		{ VertexLayout::BITANGENT, 4 },
 	};
 
-	std::vector<uint> vaos;
-	vaos.resize((int)loadedModel.shapes.size());
-	glGenVertexArrays((int)loadedModel.shapes.size(), vaos.data());
-
-	for (int i = 0; i < loadedModel.shapes.size(); i++)
-	{
-		auto& mesh = meshes.emplace_back();
-		mesh.Init(vaos[i]);
-
-		glBindVertexArray(mesh.vao);
-
-		std::vector<uint> bufferList;
-		bufferList.resize(attribLocations.size() + 1);
-
-		glGenBuffers((int)bufferList.size(), bufferList.data());
-		mesh.vertexHandles[VertexLayout::POSITION] = bufferList[0];
-		mesh.vertexHandles[VertexLayout::NORMAL] = bufferList[1];
-		mesh.vertexHandles[VertexLayout::UV] = bufferList[2];
-		mesh.vertexHandles[VertexLayout::TANGENT] = bufferList[3];
-		mesh.vertexHandles[VertexLayout::BITANGENT] = bufferList[4];
-		mesh.vertexHandles[VertexLayout::INDEX] = bufferList[5];
-
-		auto const& shape = loadedModel.shapes[i];
-		ConvertToMesh(mesh, shape);
-
-		mesh.UploadVertices(attribLocations);
-		mesh.vertexData.ClearAll();
+	// a GL hivasok aszinkronok, ez a CPU oldali atadas ideje, nem a tenyleges atvitele
+	LoadReport::ScopedPhase phase(loadedModel.name, "gpuUpload");
+
+	auto& mesh = meshes.emplace_back();
+
+	auto const& shape = loadedModel.shapes[shapeIdx];
+	ConvertToMesh(mesh, shape);
+
+	// az arenaban levo mesh a lap VAO-jat kapja, azt az UploadVertices allitja be
+	if (!mesh.isInArena) {
+		uint vao;
+		if (mesh.isInterleaved) {
+			// a DSA-val letrehozott VAO kotes nelkul is beallithato
+			glCreateVertexArrays(1, &vao);
+			mesh.Init(vao);
+		}
+		else {
+			glGenVertexArrays(1, &vao);
+			mesh.Init(vao);
+			glBindVertexArray(mesh.vao);
+		}
+
+		mesh.CreateBuffers();
+	}
+	auto uploadedBytes = mesh.UploadVertices(attribLocations);
+	mesh.vertexData.ClearAll();
+
+	theLoadReport.AddCounter(loadedModel.name, "gpuBytes", uploadedBytes);
+
+	// a betoltes mar dekodolta (vagy tomoritette), a handle a LoadedModel-lel egyutt szabadul fel
+	auto& material = loadedModel.materials[shape.materialId];
+	int diffuseTextureUnit = 0;
+
+	if (material.diffuseCompressed) {
+		if (SurfaceTexture::IsCompressedFormatSupported(material.diffuseCompressed->format)) {
+			mesh.surfaceTexture = std::make_shared<SurfaceTexture>(SurfaceTexture::Type::DIFFUSE, material.diffuseTexture, *material.diffuseCompressed, diffuseTextureUnit);
+			return;
+		}
+
+		// a driver nem ismeri a formatumot, a forras kep tomoritetlenul kerul fel
+		static bool isFallbackLogged = false;
+		if (!isFallbackLogged) {
+			theLogger.LogWarning("{} textures are not supported by the driver, uploading them uncompressed", TextureCompressor::GetFormatName(material.diffuseCompressed->format));
+			isFallbackLogged = true;
+		}
+	}
 
-		auto& material = loadedModel.materials[shape.materialId];
-		auto image = theImageCache.Load(material.diffuseTexture);
+	auto image = material.diffuseImage ? material.diffuseImage : theImageCache.Load(material.diffuseTexture);
+	mesh.surfaceTexture = std::make_shared<SurfaceTexture>(SurfaceTexture::Type::DIFFUSE, image->path, *image, diffuseTextureUnit);
+}
 
-		int diffuseTextureUnit = 0;
-		mesh.surfaceTexture = std::make_shared<SurfaceTexture>(SurfaceTexture::Type::DIFFUSE, image->path, image, diffuseTextureUnit);
-	}
+VertexStreams Object3D::GetModelVertexStreams()
+{
+	// a Vertex-ben nincs normal es tangens, a szin pedig konstans
+	return VertexStreams{ VertexLayout::POSITION, VertexLayout::UV };
 }
 
 void Object3D::ConvertToMesh(Mesh& mesh, TinyObjShape const& shape)
 {
 	mesh.vertexData.vertexCount = (int)shape.vertices.size();
-	for (auto i = 0; i < shape.vertices.size(); i++) {
-		mesh.vertexData.positions.push_back(shape.vertices[i].pos);
-		mesh.vertexData.uvs.push_back(shape.vertices[i].texCoord);
+	mesh.vertexStreams = GetModelVertexStreams();
+	mesh.isPacked = theRuncfg.packedVertices;
+	// az arena interleaved vertex-eket tarol
+	mesh.isInArena = theRuncfg.geometryArena;
+	mesh.isInterleaved = theRuncfg.interleavedVertices || mesh.isInArena;
+
+	if (mesh.isPacked) {
+		mesh.quantization = VertexPacker::ComputeQuantization(shape.vertices);
+		mesh.vertexData.packedVertices = VertexPacker::Pack(shape.vertices, mesh.quantization);
+	}
+	else {
+		for (auto i = 0; i < shape.vertices.size(); i++) {
+			mesh.vertexData.positions.push_back(shape.vertices[i].pos);
+			mesh.vertexData.uvs.push_back(shape.vertices[i].texCoord);
+		}
 	}
 
 	mesh.indicesCount = (int)shape.indices.size();
 	mesh.indices = std::move(shape.indices);
+	mesh.indexType = shape.indexType;
+
+	mesh.lods.push_back(MeshLod{ 0, mesh.indicesCount, 0.0f });
+	for (auto const& lod : shape.lods) {
+		mesh.lods.push_back(MeshLod{ (int)(mesh.indices.size() + lod.indexOffset), (int)lod.indexCount, lod.error });
+	}
+	mesh.indices.insert(mesh.indices.end(), shape.lodIndices.begin(), shape.lodIndices.end());
+
+	if (!shape.vertices.empty()) {
+		glm::vec3 boundsMin = shape.vertices[0].pos;
+		glm::vec3 boundsMax = shape.vertices[0].pos;
+		for (auto const& vertex : shape.vertices) {
+			boundsMin = glm::min(boundsMin, vertex.pos);
+			boundsMax = glm::max(boundsMax, vertex.pos);
+		}
+
+		mesh.boundingCenter = (boundsMin + boundsMax) * 0.5f;
+		mesh.boundingRadius = glm::length(boundsMax - boundsMin) * 0.5f;
+	}
 }
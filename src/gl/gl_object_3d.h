@@ -3,18 +3,11 @@
 struct Camera;
 struct GpuProgram;
 
+#include "geometry_arena.h"
 #include "surface_texture.h"
+#include "vertex_streams.h"
 #include "../model_loader.h"
-
-enum struct VertexLayout
-{
-	POSITION,
-	NORMAL,
-	UV,
-	TANGENT,
-	BITANGENT,
-	INDEX
-};
+#include "../vertex_packer.h"
 
 struct Transformation
 {
@@ -37,28 +30,71 @@ struct VertexData
 	std::vector<glm::vec3> tangents;
 	std::vector<glm::vec3> bitangents;
 
+	// POSITION + UV interleaved, ha a packedVertices be van kapcsolva
+	std::vector<PackedVertex> packedVertices;
+
 	VertexData();
 	virtual ~VertexData() = default;
 
 	void ClearAll();
 };
 
+struct MeshLod
+{
+	int indexOffset;
+	int indexCount;
+	float error;
+};
+
 struct Mesh
 {
 	uint vao;
 
 	std::unordered_map<VertexLayout, int> vertexHandles;
+	VertexStreams vertexStreams;
 	VertexData vertexData;
 	std::shared_ptr<SurfaceTexture> surfaceTexture;
 
+	bool isPacked;
+	// minden stream egy DSA bufferben, vertexenkent egymas utan
+	bool isInterleaved;
+	// a vertex-ek es indexek a kozos arenaban, a vao a lap VAO-ja
+	bool isInArena;
+	GeometryAllocation allocation;
+	VertexQuantization quantization;
+
 	int indicesCount;
 	std::vector<uint> indices;
+	IndexType indexType;
+
+	// az indices-ben egymas utan vannak a szintek, a 0. a teljes reszletessegu
+	std::vector<MeshLod> lods;
+	glm::vec3 boundingCenter;
+	float boundingRadius;
 
 	Mesh();
 	virtual ~Mesh() = default;
 
 	void Init(uint newVao);
-	void UploadVertices(std::unordered_map<VertexLayout, int>& attribLocations);
+	void CreateBuffers();
+	// Returns the number of uploaded bytes
+	size_t UploadVertices(std::unordered_map<VertexLayout, int>& attribLocations);
+
+private:
+	// Every stream of a vertex next to each other, format gets the attributes and the stride
+	std::vector<uint8_t> BuildInterleavedVertices(std::unordered_map<VertexLayout, int>& attribLocations, VertexFormat& format) const;
+	// One immutable vertex buffer and one index buffer, the VAO is set up without binding anything
+	size_t UploadInterleaved(std::unordered_map<VertexLayout, int>& attribLocations);
+	// Sub-allocates the interleaved vertices and the indices from theGeometryArena
+	size_t UploadToArena(std::unordered_map<VertexLayout, int>& attribLocations);
+};
+
+// One mesh at its selected LOD, the multi draw path batches these across objects
+struct MeshDraw
+{
+	Mesh const* mesh;
+	MeshLod const* lod;
+	glm::mat4 model;
 };
 
 struct Object3D
@@ -70,9 +106,21 @@ struct Object3D
 	virtual ~Object3D() = default;
 
 	void Draw(GpuProgram const& gpuProgram, Camera const& camera) const;
+	// Appends every mesh with the LOD to draw it at
+	void CollectDraws(Camera const& camera, std::vector<MeshDraw>& draws) const;
+	glm::mat4 GetModelMatrix() const;
 	void Create(LoadedModel const& loadedModel);
+	// Uploads one shape, lets the upload of a model be spread over several frames
+	void CreateMesh(LoadedModel const& loadedModel, size_t shapeIdx);
+
+	// The streams ConvertToMesh fills, the shader variant for the loaded models is built from these
+	static VertexStreams GetModelVertexStreams();
 
 private:
+	// a vetitett hiba legfeljebb ennyi pixel lehet
+	static constexpr float lodPixelError = 1.0f;
+
 	void ConvertToMesh(Mesh& mesh, TinyObjShape const& shape);
+	MeshLod const& SelectLod(Mesh const& mesh, glm::mat4 const& model, Camera const& camera) const;
 };
 
@@ -1,31 +1,44 @@
 #include "gl_simple_shader.h"
 
 #include "../runcfg.h"
-#include "gl_wrapper.h"
 #include "render_state.h"
 
-SimpleShader::SimpleShader()
+SimpleShader::SimpleShader(VertexStreams const& vertexStreams, bool useMultiDraw) :
+	useMultiDraw{ useMultiDraw }
 {
+	shaderDefines = vertexStreams.GetShaderDefines();
+	if (useMultiDraw) {
+		shaderDefines = "#extension GL_ARB_shader_draw_parameters : require\n#define USE_MULTI_DRAW\n" + shaderDefines;
+	}
+
 	shaderPathList.emplace_back(ShaderPath::Type::VERT, "simple.vert");
 	shaderPathList.emplace_back(ShaderPath::Type::FRAG, "simple.frag");
 	Create();
+
+	texSamplerUniform = GetUniform<int>("texSampler");
 }
 
 void SimpleShader::Bind() const
 {
+	// a view es a proj a frame eleji FrameUniforms-ban van
 	glUseProgram(programHandle);
-
-	GlWrapper::SetUniform(theRenderState.model, "model", *this);
-	GlWrapper::SetUniform(theRenderState.view, "view", *this);
-	GlWrapper::SetUniform(theRenderState.proj, "proj", *this);
 }
 
 void SimpleShader::BindMaterial() const
 {
-	theRenderState.surfaceTexture->SetUniform("texSampler", *this);
+	// a multi draw valtozat a DrawBuffer-bol olvassa a mesh adatait
+	if (!useMultiDraw) {
+		ObjectUniforms objectUniforms;
+		objectUniforms.model = theRenderState.model;
+		objectUniforms.posOffset = glm::vec4(theRenderState.posOffset, 0.0f);
+		objectUniforms.posScale = glm::vec4(theRenderState.posScale, 0.0f);
+		theRenderState.uniformRing->Bind(RenderState::objectUniformBinding, &objectUniforms, sizeof(objectUniforms));
+	}
+
+	theRenderState.surfaceTexture->SetUniform(texSamplerUniform, *this);
 }
 
 std::string SimpleShader::GetPrettyName() const
 {
-	return "SimpleShader";
+	return useMultiDraw ? "SimpleShader (multi draw)" : "SimpleShader";
 }
@@ -1,13 +1,19 @@
 #pragma once
 
 #include "gl_gpu_program.h"
+#include "vertex_streams.h"
 
 struct SimpleShader : GpuProgram
 {
-	SimpleShader();
+	// The multi draw variant reads the per-draw data from the DrawBuffer storage block by gl_DrawIDARB
+	SimpleShader(VertexStreams const& vertexStreams, bool useMultiDraw);
 	virtual ~SimpleShader() = default;
 
 	void Bind() const override;
 	void BindMaterial() const override;
 	std::string GetPrettyName() const override;
+
+private:
+	bool useMultiDraw;
+	UniformHandle<int> texSamplerUniform;
 };
@@ -1,91 +1,53 @@
 #include "gl_wrapper.h"
 
-#include "gl_gpu_program.h"
-
-std::unordered_map<int, std::unordered_map<std::string, bool>> UniformTracker::trackedMap = std::unordered_map<int, std::unordered_map<std::string, bool>>();
-
-bool UniformTracker::Contains(int gpuProgramId, std::string const& uniformName)
-{
-	auto gpuProgramIt = trackedMap.find(gpuProgramId);
-	if (gpuProgramIt != trackedMap.end())
-	{
-		auto it = gpuProgramIt->second.find(uniformName);
-		if (it != gpuProgramIt->second.end())
-		{
-			return true;
-		}
-	}
-
-	return false;
-}
-
-void UniformTracker::Track(GpuProgram const& gpuProgram, std::string const& uniformName, std::string const& uniformType)
-{
-	if (!Contains(gpuProgram.programHandle, uniformName))
-	{
-		trackedMap[gpuProgram.programHandle][uniformName] = true;
-		theLogger.LogInfo("[ shader: {} ] uniform({}) {} cannot be set", gpuProgram.GetPrettyName(), uniformType, uniformName);
-	}
-}
-
-void GlWrapper::SetUniform(glm::mat4 const& subject, std::string const& uniformName, GpuProgram const& gpuProgram)
+void GlWrapper::SetUniform(glm::mat4 const& subject, UniformHandle<glm::mat4> uniform, GpuProgram const& gpuProgram)
 {
-	auto location = glGetUniformLocation(gpuProgram.programHandle, uniformName.c_str());
-
-	if (location < 0)
-		UniformTracker::Track(gpuProgram, uniformName, "mat4");
+	auto location = gpuProgram.UpdateUniformValue(uniform.index, glm::value_ptr(subject), sizeof(subject));
 
-	glUniformMatrix4fv(location, 1, false, glm::value_ptr(subject));
+	if (location >= 0)
+		glUniformMatrix4fv(location, 1, false, glm::value_ptr(subject));
 }
 
-void GlWrapper::SetUniform(glm::mat3 const& subject, std::string const& uniformName, GpuProgram const& gpuProgram)
+void GlWrapper::SetUniform(glm::mat3 const& subject, UniformHandle<glm::mat3> uniform, GpuProgram const& gpuProgram)
 {
-	auto location = glGetUniformLocation(gpuProgram.programHandle, uniformName.c_str());
+	auto location = gpuProgram.UpdateUniformValue(uniform.index, glm::value_ptr(subject), sizeof(subject));
 
-	if (location < 0)
-		UniformTracker::Track(gpuProgram, uniformName, "mat3");
-
-	glUniformMatrix3fv(location, 1, false, glm::value_ptr(subject));
+	if (location >= 0)
+		glUniformMatrix3fv(location, 1, false, glm::value_ptr(subject));
 }
 
-void GlWrapper::SetUniform(glm::vec3 const& subject, std::string const& uniformName, GpuProgram const& gpuProgram)
+void GlWrapper::SetUniform(glm::vec3 const& subject, UniformHandle<glm::vec3> uniform, GpuProgram const& gpuProgram)
 {
-	auto location = glGetUniformLocation(gpuProgram.programHandle, uniformName.c_str());
+	auto location = gpuProgram.UpdateUniformValue(uniform.index, glm::value_ptr(subject), sizeof(subject));
 
-	if (location < 0)
-		UniformTracker::Track(gpuProgram, uniformName, "vec3");
-	
-	glUniform3fv(location, 1, glm::value_ptr(subject));
+	if (location >= 0)
+		glUniform3fv(location, 1, glm::value_ptr(subject));
 }
 
-void GlWrapper::SetUniform(std::vector<glm::mat4> const& subject, std::string const& uniformName, GpuProgram const& gpuProgram)
+void GlWrapper::SetUniform(std::vector<glm::mat4> const& subject, UniformHandle<std::vector<glm::mat4>> uniform, GpuProgram const& gpuProgram)
 {
-	auto location = glGetUniformLocation(gpuProgram.programHandle, uniformName.c_str());
+	if (subject.empty()) return;
 
-	if (location < 0)
-		UniformTracker::Track(gpuProgram, uniformName, "vector<mat4>");
+	auto location = gpuProgram.UpdateUniformValue(uniform.index, glm::value_ptr(subject[0]), sizeof(glm::mat4) * subject.size());
 
-	glUniformMatrix4fv(location, (int)subject.size(), false, glm::value_ptr(subject[0]));
+	if (location >= 0)
+		glUniformMatrix4fv(location, (int)subject.size(), false, glm::value_ptr(subject[0]));
 }
 
-void GlWrapper::SetUniform(float const subject, std::string const& uniformName, GpuProgram const& gpuProgram)
+void GlWrapper::SetUniform(float const subject, UniformHandle<float> uniform, GpuProgram const& gpuProgram)
 {
-	auto location = glGetUniformLocation(gpuProgram.programHandle, uniformName.c_str());
+	auto location = gpuProgram.UpdateUniformValue(uniform.index, &subject, sizeof(subject));
 
-	if (location < 0)
-		UniformTracker::Track(gpuProgram, uniformName, "float");
-	
-	glUniform1f(location, subject);
+	if (location >= 0)
+		glUniform1f(location, subject);
 }
 
-void GlWrapper::SetUniform(int const subject, std::string const& uniformName, GpuProgram const& gpuProgram)
+void GlWrapper::SetUniform(int const subject, UniformHandle<int> uniform, GpuProgram const& gpuProgram)
 {
-	auto location = glGetUniformLocation(gpuProgram.programHandle, uniformName.c_str());
+	auto location = gpuProgram.UpdateUniformValue(uniform.index, &subject, sizeof(subject));
 
-	if (location < 0)
-		UniformTracker::Track(gpuProgram, uniformName, "int");
-	
-	glUniform1i(location, subject);
+	if (location >= 0)
+		glUniform1i(location, subject);
 }
 
 std::string GlWrapper::GetString(GLenum const name)
@@ -107,6 +69,16 @@ GLint GlWrapper::GetProgramiv(GLuint const programHandle, GLenum const parameter
 	return result;
 }
 
+bool GlWrapper::HasExtension(std::string const& extensionName)
+{
+	auto extensionCount = GetIntegerv(GL_NUM_EXTENSIONS);
+	for (GLint i = 0; i < extensionCount; i++) {
+		if (extensionName == (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i)) return true;
+	}
+
+	return false;
+}
+
 std::string GlWrapper::ResolveDebugSource(GLenum source)
 {
 	switch (source) {
@@ -1,30 +1,25 @@
 #pragma once
 
-struct GpuProgram;
-
-struct UniformTracker
-{
-	static std::unordered_map<int, std::unordered_map<std::string, bool>> trackedMap;
-
-	static bool Contains(int gpuProgramId, std::string const& uniformName);
-	static void Track(GpuProgram const& gpuProgram, std::string const& uniformName, std::string const& uniformType);
-};
+#include "gl_gpu_program.h"
 
 struct GlWrapper
 {
-	static void SetUniform(glm::mat4 const& subject, std::string const& uniformName, GpuProgram const& gpuProgram);
-	static void SetUniform(glm::mat3 const& subject, std::string const& uniformName, GpuProgram const& gpuProgram);
-	static void SetUniform(glm::vec3 const& subject, std::string const& uniformName, GpuProgram const& gpuProgram);
-	static void SetUniform(std::vector<glm::mat4> const& subject, std::string const& uniformName, GpuProgram const& gpuProgram);
-	static void SetUniform(float subject, std::string const& uniformName, GpuProgram const& gpuProgram);
-	static void SetUniform(int subject, std::string const& uniformName, GpuProgram const& gpuProgram);
+	// The value is only uploaded if it differs from the last one set through the handle, the program has to be in use
+	static void SetUniform(glm::mat4 const& subject, UniformHandle<glm::mat4> uniform, GpuProgram const& gpuProgram);
+	static void SetUniform(glm::mat3 const& subject, UniformHandle<glm::mat3> uniform, GpuProgram const& gpuProgram);
+	static void SetUniform(glm::vec3 const& subject, UniformHandle<glm::vec3> uniform, GpuProgram const& gpuProgram);
+	static void SetUniform(std::vector<glm::mat4> const& subject, UniformHandle<std::vector<glm::mat4>> uniform, GpuProgram const& gpuProgram);
+	static void SetUniform(float subject, UniformHandle<float> uniform, GpuProgram const& gpuProgram);
+	static void SetUniform(int subject, UniformHandle<int> uniform, GpuProgram const& gpuProgram);
 
 	// Avoid explicit conversion
-	template<typename T> static void SetUniform(T const& subject, std::string const& uniformName, GpuProgram const& gpuProgram) = delete;
+	template<typename T, typename U> static void SetUniform(T const& subject, UniformHandle<U> uniform, GpuProgram const& gpuProgram) = delete;
 
 	static std::string GetString(GLenum const name);
 	static GLint GetIntegerv(GLenum const parameterName);
 	static GLint GetProgramiv(GLuint const programHandle, GLenum const parameterName);
+	// The glad loader only knows the core functions, the extensions are checked by name
+	static bool HasExtension(std::string const& extensionName);
 
 	static std::string ResolveDebugSource(GLenum source);
 	static std::string ResolveDebugType(GLenum type);
@@ -0,0 +1,57 @@
+#include "model_upload_queue.h"
+
+void ModelUploadQueue::Enqueue(std::future<LoadedModel> loadedModel, Object3D object)
+{
+	auto& entry = entries.emplace_back();
+	entry.pendingModel = std::move(loadedModel);
+	entry.object = std::move(object);
+}
+
+void ModelUploadQueue::Process(std::vector<Object3D>& drawableObjects, std::chrono::duration<double, std::milli> budget)
+{
+	auto timerStart = std::chrono::high_resolution_clock::now();
+	auto isOverBudget = [&]() {
+		return std::chrono::high_resolution_clock::now() - timerStart >= budget;
+	};
+
+	bool isFirstUpload = true;
+
+	for (auto it = entries.begin(); it != entries.end();) {
+		auto& entry = *it;
+
+		if (!entry.loadedModel) {
+			if (entry.pendingModel.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				it++;
+				continue;
+			}
+
+			try {
+				entry.loadedModel = entry.pendingModel.get();
+			}
+			catch (std::exception& e) {
+				theLogger.LogError("Model loading failed: {}", e.what());
+				it = entries.erase(it);
+				continue;
+			}
+		}
+
+		// legalabb egy mesh-t minden frame-ben feltoltunk, kulonben egy nagy mesh sosem ferne bele
+		auto const& shapes = entry.loadedModel->shapes;
+		while (entry.nextShapeIdx < shapes.size() && (isFirstUpload || !isOverBudget())) {
+			entry.object.CreateMesh(*entry.loadedModel, entry.nextShapeIdx++);
+			isFirstUpload = false;
+		}
+
+		if (entry.nextShapeIdx < shapes.size()) break;
+
+		// az Animate csak a kovetkezo frame-ben allitja be, addig se a default transzformacioval rajzoljuk
+		entry.object.animatedTransformation = entry.object.originalTransformation;
+		drawableObjects.push_back(std::move(entry.object));
+		it = entries.erase(it);
+	}
+}
+
+bool ModelUploadQueue::IsEmpty() const
+{
+	return entries.empty();
+}
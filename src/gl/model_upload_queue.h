@@ -0,0 +1,27 @@
+#pragma once
+
+#include "gl_object_3d.h"
+
+// Models loading on worker threads, uploaded on the render thread mesh by mesh under a per-frame time budget
+struct ModelUploadQueue
+{
+	ModelUploadQueue() = default;
+	~ModelUploadQueue() = default;
+
+	// object is moved to the drawable objects once all of its meshes are uploaded, its transformation can be set beforehand
+	void Enqueue(std::future<LoadedModel> loadedModel, Object3D object);
+	// Polls the loads and uploads finished models until the budget is spent, at least one mesh per call
+	void Process(std::vector<Object3D>& drawableObjects, std::chrono::duration<double, std::milli> budget);
+	bool IsEmpty() const;
+
+private:
+	struct Entry
+	{
+		std::future<LoadedModel> pendingModel;
+		std::optional<LoadedModel> loadedModel;
+		Object3D object;
+		size_t nextShapeIdx = 0;
+	};
+
+	std::deque<Entry> entries;
+};
@@ -0,0 +1,88 @@
+#include "multi_draw_renderer.h"
+
+#include "gl_wrapper.h"
+#include "render_state.h"
+
+bool MultiDrawRenderer::IsSupported()
+{
+	return GLAD_GL_VERSION_4_3 && GlWrapper::HasExtension("GL_ARB_shader_draw_parameters");
+}
+
+bool MultiDrawRenderer::IsSameBatch(Mesh const& mesh, Mesh const& other)
+{
+	return mesh.vao == other.vao && mesh.indexType == other.indexType && mesh.surfaceTexture == other.surfaceTexture;
+}
+
+void MultiDrawRenderer::Draw(std::vector<Object3D> const& objects, GpuProgram const& gpuProgram, Camera const& camera, UniformRing& uniformRing)
+{
+	draws.clear();
+	for (auto const& object : objects) {
+		object.CollectDraws(camera, draws);
+	}
+
+	if (draws.empty()) return;
+
+	// az egy batch-be tartozo mesh-ek egymas melle kerulnek
+	std::sort(draws.begin(), draws.end(), [](MeshDraw const& a, MeshDraw const& b) {
+		return std::make_tuple(a.mesh->vao, a.mesh->indexType, a.mesh->surfaceTexture.get()) < std::make_tuple(b.mesh->vao, b.mesh->indexType, b.mesh->surfaceTexture.get());
+	});
+
+	// a gl_DrawIDARB minden hivasban 0-rol indul, ezert a batch-ek DrawData tombje kulon, igazitott tartomanyba kerul
+	auto storageAlignment = uniformRing.GetStorageOffsetAlignment();
+	auto alignUp = [storageAlignment](size_t offset) { return (offset + storageAlignment - 1) / storageAlignment * storageAlignment; };
+
+	batches.clear();
+	size_t frameBytes = sizeof(DrawElementsIndirectCommand) * draws.size();
+	for (size_t drawIdx = 0; drawIdx < draws.size();) {
+		auto batchEnd = drawIdx + 1;
+		while (batchEnd < draws.size() && IsSameBatch(*draws[drawIdx].mesh, *draws[batchEnd].mesh)) batchEnd++;
+
+		auto drawDataOffset = alignUp(frameBytes);
+		batches.push_back(Batch{ drawIdx, batchEnd - drawIdx, drawDataOffset });
+		frameBytes = drawDataOffset + sizeof(DrawData) * (batchEnd - drawIdx);
+		drawIdx = batchEnd;
+	}
+
+	// egyetlen foglalas; ha a szelet betelik, a ring itt no meg, ezert a buffert es a cimet csak utana kerdezzuk le
+	auto baseOffset = uniformRing.Allocate(frameBytes, storageAlignment);
+	auto baseData = uniformRing.GetMappedData() + baseOffset;
+	auto commands = reinterpret_cast<DrawElementsIndirectCommand*>(baseData);
+
+	for (size_t drawIdx = 0; drawIdx < draws.size(); drawIdx++) {
+		auto const& draw = draws[drawIdx];
+		auto const& mesh = *draw.mesh;
+
+		auto indexSize = VertexPacker::IndexSize(mesh.indexType);
+		auto firstIndex = mesh.isInArena ? mesh.allocation.indexOffset / indexSize : 0;
+		auto baseVertex = mesh.isInArena ? mesh.allocation.baseVertex : 0;
+
+		commands[drawIdx] = DrawElementsIndirectCommand{ (GLuint)draw.lod->indexCount, 1, (GLuint)(firstIndex + draw.lod->indexOffset), baseVertex, 0 };
+	}
+
+	for (auto const& batch : batches) {
+		auto drawData = reinterpret_cast<DrawData*>(baseData + batch.drawDataOffset);
+		for (size_t drawIdx = 0; drawIdx < batch.drawCount; drawIdx++) {
+			auto const& draw = draws[batch.firstDraw + drawIdx];
+			drawData[drawIdx] = DrawData{ draw.model, glm::vec4(draw.mesh->quantization.offset, 0.0f), glm::vec4(draw.mesh->quantization.scale, 0.0f) };
+		}
+	}
+
+	gpuProgram.Bind();
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, uniformRing.GetBuffer());
+
+	for (auto const& batch : batches) {
+		auto const& mesh = *draws[batch.firstDraw].mesh;
+
+		theRenderState.surfaceTexture = mesh.surfaceTexture.get();
+		gpuProgram.BindMaterial();
+
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, drawDataBinding, uniformRing.GetBuffer(), (GLintptr)(baseOffset + batch.drawDataOffset), (GLsizeiptr)(sizeof(DrawData) * batch.drawCount));
+		glBindVertexArray(mesh.vao);
+
+		auto indexType = mesh.indexType == IndexType::UINT16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+		auto commandOffset = baseOffset + sizeof(DrawElementsIndirectCommand) * batch.firstDraw;
+		glMultiDrawElementsIndirect(GL_TRIANGLES, indexType, (void const*)commandOffset, (GLsizei)batch.drawCount, 0);
+	}
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
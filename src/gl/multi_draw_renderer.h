@@ -0,0 +1,56 @@
+#pragma once
+#include "../pch.h"
+
+#include "../camera.h"
+#include "gl_gpu_program.h"
+#include "gl_object_3d.h"
+#include "uniform_ring.h"
+
+// The layout glMultiDrawElementsIndirect reads
+struct DrawElementsIndirectCommand
+{
+	GLuint count;
+	GLuint instanceCount;
+	GLuint firstIndex;
+	GLint baseVertex;
+	GLuint baseInstance;
+};
+
+// std430 layout of one element of the DrawBuffer storage block, indexed by gl_DrawIDARB
+struct DrawData
+{
+	glm::mat4 model;
+	glm::vec4 posOffset;	// w unused
+	glm::vec4 posScale;		// w unused
+};
+
+static_assert(sizeof(DrawElementsIndirectCommand) == 20, "DrawElementsIndirectCommand must match the GL layout");
+static_assert(sizeof(DrawData) == 96, "DrawData must match the std430 layout");
+
+// Draws the meshes of every object with one glMultiDrawElementsIndirect per batch; the meshes of a batch
+// share the VAO (an arena page), the index type and the texture. The commands and the per-draw data are
+// written into the uniform ring, so the GL calls of a frame depend on the batch count, not the mesh count.
+struct MultiDrawRenderer
+{
+	static constexpr GLuint drawDataBinding = 0;
+
+	// Multi draw indirect is core since 4.3, gl_DrawIDARB needs GL_ARB_shader_draw_parameters
+	static bool IsSupported();
+
+	// gpuProgram has to be the multi draw variant
+	void Draw(std::vector<Object3D> const& objects, GpuProgram const& gpuProgram, Camera const& camera, UniformRing& uniformRing);
+
+private:
+	struct Batch
+	{
+		size_t firstDraw;
+		size_t drawCount;
+		size_t drawDataOffset;
+	};
+
+	// frame-rol frame-re ujrahasznalva, igy nincs frame-enkenti foglalas
+	std::vector<MeshDraw> draws;
+	std::vector<Batch> batches;
+
+	static bool IsSameBatch(Mesh const& mesh, Mesh const& other);
+};
@@ -1,6 +1,9 @@
 #include "opengl_context.h"
 
+#include "../runcfg.h"
+#include "geometry_arena.h"
 #include "gl_wrapper.h"
+#include "render_state.h"
 
 OpenGlContext::OpenGlContext() :
 	useGlDebugCallback{ true }
@@ -37,7 +40,19 @@ void OpenGlContext::initGL()
 	initGlad();
 	initGlDebugCallback();
 
-	simpleShader = std::make_unique<SimpleShader>();
+	// a kiterjesztes nelkul a mesh-enkenti rajzolas marad
+	auto useMultiDraw = theRuncfg.multiDrawIndirect && MultiDrawRenderer::IsSupported();
+	if (theRuncfg.multiDrawIndirect && !useMultiDraw) {
+		theLogger.LogWarning("GL_ARB_shader_draw_parameters is not supported, drawing mesh by mesh");
+	}
+
+	simpleShader = std::make_unique<SimpleShader>(Object3D::GetModelVertexStreams(), useMultiDraw);
+	if (useMultiDraw) {
+		multiDrawRenderer = std::make_unique<MultiDrawRenderer>();
+	}
+
+	uniformRing = std::make_unique<UniformRing>(uniformRingFrameBytes);
+	theRenderState.uniformRing = uniformRing.get();
 
 	simpleScene.Create(windowSize);
 }
@@ -58,6 +73,8 @@ void OpenGlContext::animateGL(float currentTime)
 
 void OpenGlContext::drawFrameGL()
 {
+	simpleScene.UploadLoadedModels();
+
 	glViewport(0, 0, windowSize.width, windowSize.height);
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
@@ -68,10 +85,26 @@ void OpenGlContext::drawFrameGL()
 	glEnable(GL_DEPTH_TEST);
 	glEnable(GL_CULL_FACE);
 
-	for (auto const& object3d : simpleScene.drawableObjects) {
-		object3d.Draw(*simpleShader, *camera);
+	// a GPU legfeljebb ket frame-mel jar mogottunk, a harmadik szelet mar szabadon irhato
+	uniformRing->BeginFrame();
+
+	theRenderState.view = camera->V();
+	theRenderState.proj = camera->P();
+
+	FrameUniforms frameUniforms{ theRenderState.view, theRenderState.proj };
+	uniformRing->BindFrameBlock(RenderState::frameUniformBinding, &frameUniforms, sizeof(frameUniforms));
+
+	if (multiDrawRenderer) {
+		multiDrawRenderer->Draw(simpleScene.drawableObjects, *simpleShader, *camera, *uniformRing);
+	}
+	else {
+		for (auto const& object3d : simpleScene.drawableObjects) {
+			object3d.Draw(*simpleShader, *camera);
+		}
 	}
 
+	uniformRing->EndFrame();
+
 	glDisable(GL_CULL_FACE);
 	glDisable(GL_DEPTH_TEST);
 
@@ -80,7 +113,12 @@ void OpenGlContext::drawFrameGL()
 
 void OpenGlContext::cleanupGL()
 {
-	// egyelore semmit nem kell kitakaritani
+	// a ring a fence-ekre var es a buffert torli, ehhez meg kell a context (a glfwTerminate utana jon)
+	theRenderState.uniformRing = nullptr;
+	uniformRing.reset();
+
+	// az arena singleton, a lapjait a context megszunese elott itt toroljuk
+	theGeometryArena.Release();
 }
 
 void OpenGlContext::initGlad()
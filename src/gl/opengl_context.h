@@ -4,7 +4,9 @@
 #include "../utils.h"
 #include "gl_simple_shader.h"
 #include "gl_object_3d.h"
+#include "multi_draw_renderer.h"
 #include "simple_scene.h"
+#include "uniform_ring.h"
 
 struct OpenGlContext
 {
@@ -19,12 +21,18 @@ struct OpenGlContext
 	void cleanupGL();
 
 private:
+	// 256 byte-os igazitas mellett kb. 4000 mesh rajzolasa egy frame-ben
+	static constexpr size_t uniformRingFrameBytes = size_t{ 1 } * 1024 * 1024;
+
 	bool useGlDebugCallback;
 
 	GLFWwindow* window;
 	Camera* camera;
 	Utils::WindowSize windowSize;
 	std::unique_ptr<SimpleShader> simpleShader;
+	std::unique_ptr<UniformRing> uniformRing;
+	// nullptr, ha mesh-enkent rajzolunk
+	std::unique_ptr<MultiDrawRenderer> multiDrawRenderer;
 
 	SimpleScene simpleScene;
 
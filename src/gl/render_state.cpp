@@ -6,6 +6,10 @@ RenderState& RenderState::Instance()
 	return renderState;
 }
 
-RenderState::RenderState()
+RenderState::RenderState() :
+	surfaceTexture{ nullptr },
+	uniformRing{ nullptr },
+	posOffset{ 0.0f, 0.0f, 0.0f },
+	posScale{ 1.0f, 1.0f, 1.0f }
 {
 }
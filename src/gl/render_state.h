@@ -1,12 +1,35 @@
 #pragma once
 
 #include "surface_texture.h"
+#include "uniform_ring.h"
+
+// std140 layout of the FrameUniforms block, written once per frame
+struct FrameUniforms
+{
+	glm::mat4 view;
+	glm::mat4 proj;
+};
+
+// std140 layout of the ObjectUniforms block, one slice per mesh draw
+struct ObjectUniforms
+{
+	glm::mat4 model;
+	glm::vec4 posOffset;	// w unused
+	glm::vec4 posScale;		// w unused
+};
+
+static_assert(sizeof(FrameUniforms) == 128 && sizeof(ObjectUniforms) == 96, "uniform blocks must match the std140 layout");
 
 struct RenderState
 {
+	static constexpr GLuint frameUniformBinding = 0;
+	static constexpr GLuint objectUniformBinding = 1;
+
 	SurfaceTexture* surfaceTexture;
+	UniformRing* uniformRing;
 
 	glm::mat4 model, view, proj;
+	glm::vec3 posOffset, posScale;
 
 	static RenderState& Instance();
 
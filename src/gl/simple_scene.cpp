@@ -3,6 +3,7 @@
 #include "gl_object_3d.h"
 #include "../runcfg.h"
 #include "../image_cache.h"
+#include "../load_report.h"
 
 void SimpleScene::Create(Utils::WindowSize windowSize)
 {
@@ -47,33 +48,50 @@ void SimpleScene::Create(Utils::WindowSize windowSize)
 		//mesh.indices.push_back(3);
 	}
 
+	// a modellek a worker szalakon toltodnek, a feltoltes frame-enkent az UploadLoadedModels-ben tortenik
+
 	// viking room
 	{
 		Object3D vikingRoom;
-		vikingRoom.Create(LoadVikingRoom());
-		drawableObjects.push_back(std::move(vikingRoom));
+		uploadQueue.Enqueue(LoadVikingRoom(), std::move(vikingRoom));
 	}
 
 	// erato
 	{
 		//Object3D erato;
-		//erato.Create(LoadErato());
-		//drawableObjects.push_back(std::move(erato));
+		//uploadQueue.Enqueue(LoadErato(), std::move(erato));
 	}
 
 	// sponza
 	{
 		//Object3D sponza;
 		//sponza.originalTransformation.scale = glm::vec3(0.01f);
-		//sponza.Create(LoadSponza());
-		//drawableObjects.push_back(std::move(sponza));
+		//uploadQueue.Enqueue(LoadSponza(), std::move(sponza));
 	}
 
 	// dragon
 	{
 		// Object3D dragon;
-		// dragon.Create(LoadDragon());
-		// drawableObjects.push_back(std::move(dragon));
+		// uploadQueue.Enqueue(LoadDragon(), std::move(dragon));
+	}
+
+	// block textures
+	{
+		LoadBlockTextures();
+	}
+}
+
+void SimpleScene::UploadLoadedModels()
+{
+	if (uploadQueue.IsEmpty()) return;
+
+	uploadQueue.Process(drawableObjects, uploadBudget);
+
+	// az utolso modell feltoltesevel ert veget az inditas
+	if (uploadQueue.IsEmpty()) {
+		theLoadReport.Write(theRuncfg.loadReportPath);
+		theImageCache.LogStats();
+		theGeometryArena.LogStats();
 	}
 }
 
@@ -87,37 +105,40 @@ void SimpleScene::Animate(float currentTime, float deltaTime)
 	}
 }
 
-LoadedModel SimpleScene::LoadVikingRoom()
+std::future<LoadedModel> SimpleScene::LoadVikingRoom()
 {
 	auto baseDir = theRuncfg.texturesDir / "viking_room";
 	auto modelFileName = (baseDir / "viking_room.obj").string();
 	auto mtlDirectory = baseDir.string();
 
-	ModelLoader modelLoader;
-	return modelLoader.Load(modelFileName, mtlDirectory, ModelLoader::LoadSettings{});
+	return ModelLoader::LoadAsync(modelFileName, mtlDirectory, ModelLoader::LoadSettings{});
 }
 
-LoadedModel SimpleScene::LoadErato()
+std::future<LoadedModel> SimpleScene::LoadErato()
 {
 	auto baseDir = theRuncfg.texturesDir / "erato";
 	auto modelFileName = (baseDir / "erato.obj").string();
 	auto mtlDirectory = baseDir.string();
 
-	ModelLoader modelLoader;
-	return modelLoader.Load(modelFileName, mtlDirectory, ModelLoader::LoadSettings{});
+	return ModelLoader::LoadAsync(modelFileName, mtlDirectory, ModelLoader::LoadSettings{});
 }
 
-LoadedModel SimpleScene::LoadSponza()
+std::future<LoadedModel> SimpleScene::LoadSponza()
 {
 	auto baseDir = theRuncfg.texturesDir / "sponza";
 	auto modelFileName = (baseDir / "sponza.obj").string();
 	auto mtlDirectory = baseDir.string();
 
-	ModelLoader modelLoader;
-	return modelLoader.Load(modelFileName, mtlDirectory, ModelLoader::LoadSettings{});
+	ModelLoader::LoadSettings loadSettings;
+	loadSettings.optimizeVertexCache = true;
+	loadSettings.optimizeOverdraw = true;
+	loadSettings.optimizeVertexFetch = true;
+	loadSettings.mergeByMaterial = true;
+
+	return ModelLoader::LoadAsync(modelFileName, mtlDirectory, loadSettings);
 }
 
-LoadedModel SimpleScene::LoadDragon()
+std::future<LoadedModel> SimpleScene::LoadDragon()
 {
 	auto baseDir = theRuncfg.texturesDir / "dragon";
 	auto modelFileName = (baseDir / "dragon.obj").string();
@@ -125,7 +146,22 @@ LoadedModel SimpleScene::LoadDragon()
 
 	ModelLoader::LoadSettings loadSettings;
 	loadSettings.ignoreMissingUVs = true;
+	loadSettings.optimizeVertexCache = true;
+	loadSettings.optimizeOverdraw = true;
+	loadSettings.optimizeVertexFetch = true;
+	loadSettings.lodCount = 4;
+
+	return ModelLoader::LoadAsync(modelFileName, mtlDirectory, loadSettings);
+}
+
+void SimpleScene::LoadBlockTextures()
+{
+	auto blockTexturesDir = theRuncfg.texturesDir / "blocks";
+	if (!fs::is_directory(blockTexturesDir)) return;
+
+	blockTextureSet = TexturePacker::Pack(blockTexturesDir, TexturePacker::ParseLayout(theRuncfg.blockTextureLayout));
+	blockTexture = std::make_unique<BlockTexture>(blockTextureSet, blockTextureUnit);
 
-	ModelLoader modelLoader;
-	return modelLoader.Load(modelFileName, mtlDirectory, loadSettings);
+	// a pixelek mar a GPU-n vannak, csak a tablak kellenek
+	blockTextureSet.layers.clear();
 }
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "../model_loader.h"
+#include "../texture_packer.h"
 #include "../utils.h"
+#include "block_texture.h"
 #include "gl_object_3d.h"
+#include "model_upload_queue.h"
 #include "surface_texture.h"
 
 struct SimpleScene
@@ -12,12 +15,25 @@ struct SimpleScene
 
 	std::vector<Object3D> drawableObjects;
 
+	// Every block texture behind one binding, the tile and block face tables stay on the CPU for chunk meshing
+	BlockTextureSet blockTextureSet;
+	std::unique_ptr<BlockTexture> blockTexture;
+
 	void Create(Utils::WindowSize windowSize);
 	void Animate(float currentTime, float deltaTime);
+	void UploadLoadedModels();
 
 private:
-	LoadedModel LoadVikingRoom();
-	LoadedModel LoadErato();
-	LoadedModel LoadSponza();
-	LoadedModel LoadDragon();
+	// ennyi ideig tolthet fel mesh-eket egy frame
+	static constexpr std::chrono::duration<double, std::milli> uploadBudget{ 4.0 };
+	// a 0. a mesh-ek diffuse texturaje
+	static constexpr GLuint blockTextureUnit = 1;
+
+	ModelUploadQueue uploadQueue;
+
+	std::future<LoadedModel> LoadVikingRoom();
+	std::future<LoadedModel> LoadErato();
+	std::future<LoadedModel> LoadSponza();
+	std::future<LoadedModel> LoadDragon();
+	void LoadBlockTextures();
 };
\ No newline at end of file
@@ -2,7 +2,16 @@
 
 #include "gl_wrapper.h"
 
-SurfaceTexture::SurfaceTexture(Type const& type, std::string const& path, Image* image, GLuint textureUnit) :
+// az S3TC csak kiterjesztes, a glad fejlec nem feltetlenul tartalmazza
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+SurfaceTexture::SurfaceTexture(Type const& type, std::string const& path, Image const& image, GLuint textureUnit) :
 	texture{ 0 , textureUnit },
 	type{ type },
 	path{ path }
@@ -10,18 +19,67 @@ SurfaceTexture::SurfaceTexture(Type const& type, std::string const& path, Image*
 	glGenTextures(1, &texture.handle);
 	glBindTexture(GL_TEXTURE_2D, texture.handle);
 
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image->imageSize.x, image->imageSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, image->data.get());
+	// a teljes, elore elkeszitett mip lanc egyetlen pixel unpack buffer-be kerul, a szintek onnan toltodnek fel
+	GLuint uploadBuffer;
+	glGenBuffers(1, &uploadBuffer);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBuffer);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)image.GetChainSizeBytes(), nullptr, GL_STREAM_DRAW);
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	auto uploadPtr = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)image.GetChainSizeBytes(), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+	size_t uploadOffset = 0;
+	for (uint32_t levelIdx = 0; levelIdx < image.GetLevelCount(); levelIdx++) {
+		std::memcpy(uploadPtr + uploadOffset, image.GetLevelPixels(levelIdx), image.GetLevelSizeBytes(levelIdx));
+		uploadOffset += image.GetLevelSizeBytes(levelIdx);
+	}
+	glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
 
-	// When magnifying the image (no bigger mipmap available), use LINEAR filtering
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	// a kep a sajat csatornaszamaval kerul fel, az 1 es 3 csatornas sorok nem 4 byte-ra igazitottak
+	GLint internalFormat;
+	GLenum pixelFormat;
+	GetUploadFormat(image.format, internalFormat, pixelFormat);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-	// When minifying the image, use a LINEAR blend of two mipmaps, each filtered LINEARLY too
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	uploadOffset = 0;
+	for (uint32_t levelIdx = 0; levelIdx < image.GetLevelCount(); levelIdx++) {
+		auto levelSize = image.GetLevelSize(levelIdx);
+		glTexImage2D(GL_TEXTURE_2D, (GLint)levelIdx, internalFormat, levelSize.x, levelSize.y, 0, pixelFormat, GL_UNSIGNED_BYTE, reinterpret_cast<void const*>(uploadOffset));
+		uploadOffset += image.GetLevelSizeBytes(levelIdx);
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glDeleteBuffers(1, &uploadBuffer);
 
-	glGenerateMipmap(GL_TEXTURE_2D);
+	// a shader tovabbra is RGBA-t lat: a szurke a szin csatornakba, a hianyzo alpha 1-re
+	if (image.format == PixelFormat::R8 || image.format == PixelFormat::RG8) {
+		GLint alphaSource = image.format == PixelFormat::RG8 ? GL_GREEN : GL_ONE;
+		std::array<GLint, 4> swizzle = { GL_RED, GL_RED, GL_RED, alphaSource };
+		glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle.data());
+	}
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)image.GetLevelCount() - 1);
+
+	SetSamplerParameters();
+}
+
+SurfaceTexture::SurfaceTexture(Type const& type, std::string const& path, CompressedTexture const& compressedTexture, GLuint textureUnit) :
+	texture{ 0 , textureUnit },
+	type{ type },
+	path{ path }
+{
+	glGenTextures(1, &texture.handle);
+	glBindTexture(GL_TEXTURE_2D, texture.handle);
+
+	// a tomoritett lanc is elore elkeszult
+	auto internalFormat = GetCompressedFormat(compressedTexture.format);
+	for (size_t levelIdx = 0; levelIdx < compressedTexture.levels.size(); levelIdx++) {
+		auto const& level = compressedTexture.levels[levelIdx];
+		glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)levelIdx, internalFormat, level.size.x, level.size.y, 0, (GLsizei)level.data.size(), level.data.data());
+	}
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)compressedTexture.levels.size() - 1);
+
+	SetSamplerParameters();
 }
 
 GLuint SurfaceTexture::GetHandle() const
@@ -29,10 +87,54 @@ GLuint SurfaceTexture::GetHandle() const
 	return texture.handle;
 }
 
-void SurfaceTexture::SetUniform(std::string const& uniformName, GpuProgram const& gpuProgram) const
+void SurfaceTexture::SetUniform(UniformHandle<int> uniform, GpuProgram const& gpuProgram) const
 {
-	GlWrapper::SetUniform(static_cast<int>(texture.unit), uniformName, gpuProgram);
+	GlWrapper::SetUniform(static_cast<int>(texture.unit), uniform, gpuProgram);
 
 	glActiveTexture(GL_TEXTURE0 + texture.unit);
 	glBindTexture(GL_TEXTURE_2D, texture.handle);
-}
\ No newline at end of file
+}
+
+bool SurfaceTexture::IsCompressedFormatSupported(BlockFormat format)
+{
+	if (format == BlockFormat::BC7) return true;
+
+	// textura feltolteskor hivjuk, a kiterjesztes lista egyszer eleg
+	static bool const hasS3tc = GlWrapper::HasExtension("GL_EXT_texture_compression_s3tc");
+	return hasS3tc;
+}
+
+GLenum SurfaceTexture::GetCompressedFormat(BlockFormat format)
+{
+	switch (format) {
+	case BlockFormat::BC1: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+	case BlockFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	case BlockFormat::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+	}
+
+	throw std::runtime_error("unknown block format");
+}
+
+void SurfaceTexture::GetUploadFormat(PixelFormat format, GLint& internalFormat, GLenum& pixelFormat)
+{
+	switch (format) {
+	case PixelFormat::R8: internalFormat = GL_R8; pixelFormat = GL_RED; return;
+	case PixelFormat::RG8: internalFormat = GL_RG8; pixelFormat = GL_RG; return;
+	case PixelFormat::RGB8: internalFormat = GL_RGB8; pixelFormat = GL_RGB; return;
+	case PixelFormat::RGBA8: internalFormat = GL_RGBA8; pixelFormat = GL_RGBA; return;
+	}
+
+	throw std::runtime_error("unknown pixel format");
+}
+
+void SurfaceTexture::SetSamplerParameters()
+{
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	// When magnifying the image (no bigger mipmap available), use LINEAR filtering
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	// When minifying the image, use a LINEAR blend of two mipmaps, each filtered LINEARLY too
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+}
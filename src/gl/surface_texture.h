@@ -2,6 +2,7 @@
 #include "../pch.h"
 
 #include "../image_cache.h"
+#include "../texture_compressor.h"
 #include "gl_gpu_program.h"
 
 struct SurfaceTexture
@@ -12,9 +13,20 @@ struct SurfaceTexture
 
 	std::string path;
 
-	SurfaceTexture(Type const& type, std::string const& path, Image* image, GLuint textureUnit);
+	// Uploads the image's mip chain in one transfer, in the image's own channel count
+	SurfaceTexture(Type const& type, std::string const& path, Image const& image, GLuint textureUnit);
+	// Uploads the precomputed mip chain as it is
+	SurfaceTexture(Type const& type, std::string const& path, CompressedTexture const& compressedTexture, GLuint textureUnit);
 	~SurfaceTexture() = default;
 
 	GLuint GetHandle() const;
-	void SetUniform(std::string const& uniformName, GpuProgram const& gpuProgram) const;
+	void SetUniform(UniformHandle<int> uniform, GpuProgram const& gpuProgram) const;
+
+	// BPTC is core since 4.2, S3TC (BC1, BC3) is only an extension
+	static bool IsCompressedFormatSupported(BlockFormat format);
+	static GLenum GetCompressedFormat(BlockFormat format);
+	static void GetUploadFormat(PixelFormat format, GLint& internalFormat, GLenum& pixelFormat);
+
+private:
+	void SetSamplerParameters();
 };
@@ -0,0 +1,155 @@
+#include "uniform_ring.h"
+
+#include "gl_wrapper.h"
+
+UniformRing::UniformRing(size_t frameBytes) :
+	buffer{ 0 },
+	mappedData{ nullptr },
+	frameBytes{ frameBytes },
+	offsetAlignment{ (size_t)std::max(GlWrapper::GetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT), 1) },
+	storageOffsetAlignment{ (size_t)std::max(GlWrapper::GetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT), 1) },
+	frameIdx{ 0 },
+	writeOffset{ 0 },
+	fences{},
+	frameBlockBinding{ 0 }
+{
+	CreateBuffer();
+}
+
+UniformRing::~UniformRing()
+{
+	DestroyBuffer();
+}
+
+void UniformRing::CreateBuffer()
+{
+	// a szeletek hatara is igazitott, igy barmelyik szelet eleje kothato
+	auto sliceAlignment = std::lcm(std::lcm(offsetAlignment, storageOffsetAlignment), size_t{ 16 });
+	frameBytes = (frameBytes + sliceAlignment - 1) / sliceAlignment * sliceAlignment;
+	auto bufferBytes = (GLsizeiptr)(frameBytes * frameCount);
+
+	auto flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glCreateBuffers(1, &buffer);
+	glNamedBufferStorage(buffer, bufferBytes, nullptr, flags);
+
+	mappedData = static_cast<uint8_t*>(glMapNamedBufferRange(buffer, 0, bufferBytes, flags));
+	if (!mappedData) throw std::runtime_error("Failed to map the uniform ring buffer");
+
+	theLogger.LogInfo("Uniform ring: {} x {} KB, offset alignment {}", frameCount, frameBytes / 1024, offsetAlignment);
+}
+
+void UniformRing::DestroyBuffer()
+{
+	for (uint32_t slot = 0; slot < frameCount; slot++) {
+		WaitFence(slot);
+	}
+
+	if (buffer) {
+		glUnmapNamedBuffer(buffer);
+		glDeleteBuffers(1, &buffer);
+	}
+
+	buffer = 0;
+	mappedData = nullptr;
+}
+
+void UniformRing::WaitFence(uint32_t slot)
+{
+	auto& fence = fences[slot];
+	if (!fence) return;
+
+	// az elso varakozas uriti a parancsokat, kulonben a fence sosem jelezne
+	GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+	while (true) {
+		auto result = glClientWaitSync(fence, waitFlags, 1'000'000'000);
+		if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) break;
+		if (result == GL_WAIT_FAILED) {
+			theLogger.LogError("Uniform ring fence wait failed");
+			break;
+		}
+		waitFlags = 0;
+	}
+
+	glDeleteSync(fence);
+	fence = nullptr;
+}
+
+void UniformRing::BeginFrame()
+{
+	frameIdx = (frameIdx + 1) % frameCount;
+	WaitFence(frameIdx);
+	writeOffset = 0;
+	frameBlock.clear();
+}
+
+void UniformRing::EndFrame()
+{
+	fences[frameIdx] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void UniformRing::Bind(GLuint binding, void const* data, size_t sizeBytes)
+{
+	auto bufferOffset = Allocate(sizeBytes, offsetAlignment);
+	std::memcpy(mappedData + bufferOffset, data, sizeBytes);
+	glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, (GLintptr)bufferOffset, (GLsizeiptr)sizeBytes);
+}
+
+void UniformRing::BindFrameBlock(GLuint binding, void const* data, size_t sizeBytes)
+{
+	Bind(binding, data, sizeBytes);
+
+	frameBlockBinding = binding;
+	auto bytes = static_cast<uint8_t const*>(data);
+	frameBlock.assign(bytes, bytes + sizeBytes);
+}
+
+size_t UniformRing::Allocate(size_t sizeBytes, size_t alignment)
+{
+	// az igazitas nem feltetlenul ketto hatvany, a szelet eleje viszont mindegyikhez igazodik
+	auto offset = (writeOffset + alignment - 1) / alignment * alignment;
+
+	if (offset + sizeBytes > frameBytes) {
+		Grow(sizeBytes, alignment);
+		offset = (writeOffset + alignment - 1) / alignment * alignment;
+	}
+
+	writeOffset = offset + sizeBytes;
+	return frameBytes * frameIdx + offset;
+}
+
+void UniformRing::Grow(size_t sizeBytes, size_t alignment)
+{
+	// a szeletben a frame blokk es a keres is elfer, a ket igazitas okozta res is beleszamitva
+	auto requiredBytes = frameBlock.size() + offsetAlignment + alignment + sizeBytes;
+	auto newFrameBytes = frameBytes * 2;
+	while (newFrameBytes < requiredBytes) newFrameBytes *= 2;
+
+	theLogger.LogWarning("Uniform ring frame slot of {} KB is full, growing to {} KB", frameBytes / 1024, newFrameBytes / 1024);
+
+	// a frame eddigi rajzolasai a regi bufferbol olvasnak, a GPU-t megvarva az torolheto
+	glFinish();
+	DestroyBuffer();
+	frameBytes = newFrameBytes;
+	CreateBuffer();
+
+	// a frame tovabbi rajzolasai is latjak a frame blokkot, ezert az uj szelet elejere kerul
+	writeOffset = 0;
+	if (!frameBlock.empty()) {
+		Bind(frameBlockBinding, frameBlock.data(), frameBlock.size());
+	}
+}
+
+GLuint UniformRing::GetBuffer() const
+{
+	return buffer;
+}
+
+uint8_t* UniformRing::GetMappedData() const
+{
+	return mappedData;
+}
+
+size_t UniformRing::GetStorageOffsetAlignment() const
+{
+	return storageOffsetAlignment;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "../pch.h"
+
+// Uniform data written straight into a persistently mapped, coherent buffer. The buffer has one slot per
+// frame in flight, a slot is reused only after the fence of the frame that last used it has signaled.
+// The indirect draw commands and the per-draw storage blocks of a frame live in the same slot.
+struct UniformRing
+{
+	static constexpr uint32_t frameCount = 3;
+
+	explicit UniformRing(size_t frameBytes);
+	~UniformRing();
+
+	UniformRing(UniformRing const&) = delete;
+	UniformRing& operator=(UniformRing const&) = delete;
+	UniformRing(UniformRing&&) = delete;
+	UniformRing& operator=(UniformRing&&) = delete;
+
+	// Moves to the next slot and waits until the GPU is done with it
+	void BeginFrame();
+	// Fences the commands that read the current slot
+	void EndFrame();
+
+	// Copies the data into the current slot and binds that range to the uniform block binding
+	void Bind(GLuint binding, void const* data, size_t sizeBytes);
+	// Bind for the block every draw of the frame reads, it is written and bound again if the ring grows mid-frame
+	void BindFrameBlock(GLuint binding, void const* data, size_t sizeBytes);
+	// Reserves sizeBytes in the current slot, returns the offset in GetBuffer, the data is written through GetMappedData.
+	// A full slot makes the ring grow at once, so the offsets and the buffer of earlier calls are only valid until the next one.
+	size_t Allocate(size_t sizeBytes, size_t alignment);
+
+	GLuint GetBuffer() const;
+	uint8_t* GetMappedData() const;
+	size_t GetStorageOffsetAlignment() const;
+
+private:
+	GLuint buffer;
+	uint8_t* mappedData;
+	size_t frameBytes;
+	size_t offsetAlignment;
+	size_t storageOffsetAlignment;
+
+	uint32_t frameIdx;
+	size_t writeOffset;
+	std::array<GLsync, frameCount> fences;
+
+	// a frame blokk masolata, noveleskor ez kerul az uj szelet elejere
+	GLuint frameBlockBinding;
+	std::vector<uint8_t> frameBlock;
+
+	void CreateBuffer();
+	void DestroyBuffer();
+	void WaitFence(uint32_t slot);
+	// Waits for the GPU and replaces the buffer with one whose slots fit the frame block and sizeBytes
+	void Grow(size_t sizeBytes, size_t alignment);
+};
@@ -0,0 +1,49 @@
+#include "vertex_streams.h"
+
+static uint32_t GetBit(VertexLayout layout)
+{
+	return 1u << static_cast<uint32_t>(layout);
+}
+
+VertexStreams::VertexStreams() :
+	mask{ 0 }
+{
+}
+
+VertexStreams::VertexStreams(std::initializer_list<VertexLayout> layouts) :
+	mask{ 0 }
+{
+	for (auto layout : layouts) {
+		Add(layout);
+	}
+}
+
+void VertexStreams::Add(VertexLayout layout)
+{
+	mask |= GetBit(layout);
+}
+
+bool VertexStreams::Has(VertexLayout layout) const
+{
+	return (mask & GetBit(layout)) != 0;
+}
+
+std::string VertexStreams::GetShaderDefines() const
+{
+	static const std::array<std::pair<VertexLayout, char const*>, 5> streamNames = { {
+		{ VertexLayout::POSITION, "HAS_POSITION" },
+		{ VertexLayout::NORMAL, "HAS_NORMAL" },
+		{ VertexLayout::UV, "HAS_UV" },
+		{ VertexLayout::TANGENT, "HAS_TANGENT" },
+		{ VertexLayout::BITANGENT, "HAS_BITANGENT" },
+	} };
+
+	std::string defines;
+	for (auto const& [layout, name] : streamNames) {
+		if (Has(layout)) {
+			defines += fmt::format("#define {}\n", name);
+		}
+	}
+
+	return defines;
+}
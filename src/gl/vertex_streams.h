@@ -0,0 +1,26 @@
+#pragma once
+
+enum struct VertexLayout
+{
+	POSITION,
+	NORMAL,
+	UV,
+	TANGENT,
+	BITANGENT,
+	INDEX
+};
+
+// The vertex attribute streams a mesh actually has, only these get buffers and shader inputs
+struct VertexStreams
+{
+	uint32_t mask;
+
+	VertexStreams();
+	VertexStreams(std::initializer_list<VertexLayout> layouts);
+
+	void Add(VertexLayout layout);
+	bool Has(VertexLayout layout) const;
+
+	// "#define HAS_<STREAM>" lines for the matching shader variant
+	std::string GetShaderDefines() const;
+};
@@ -1,45 +1,299 @@
 #include "image_cache.h"
 
+#include "image_disk_cache.h"
+#include "load_report.h"
+#include "mip_generator.h"
+#include "thread_pool.h"
+
 ImageCache& ImageCache::Instance()
 {
 	static ImageCache instance;
 	return instance;
 }
 
-Image* ImageCache::Load(std::string const& path)
+void Image::StbiDeleter::operator()(unsigned char* pixels) const
+{
+	stbi_image_free(pixels);
+}
+
+size_t Image::GetSizeBytes() const
+{
+	return static_cast<size_t>(PixelConverter::GetChannelCount(format)) * imageSize.x * imageSize.y;
+}
+
+void Image::UpdateLevels()
+{
+	levels.clear();
+	levels.push_back(LevelView{ imageSize, data.get(), GetSizeBytes() });
+	for (auto const& level : mipLevels) {
+		levels.push_back(LevelView{ level.size, level.pixels.data(), level.pixels.size() });
+	}
+}
+
+size_t Image::GetChainSizeBytes() const
+{
+	size_t sizeBytes = 0;
+	for (auto const& level : levels) {
+		sizeBytes += level.sizeBytes;
+	}
+
+	return sizeBytes;
+}
+
+uint32_t Image::GetLevelCount() const
 {
-	// Egyesével meg kell nézni, hogy már nem lett-e betöltve,
-	// mert ha igen, akkor nem kell még egyszer
-	for (auto const& imageCandidate : loadedImages) {
-		if (imageCandidate->path == path) {
-			return imageCandidate.get();
+	return static_cast<uint32_t>(levels.size());
+}
+
+glm::ivec2 Image::GetLevelSize(uint32_t level) const
+{
+	return levels[level].size;
+}
+
+uint8_t const* Image::GetLevelPixels(uint32_t level) const
+{
+	return levels[level].pixels;
+}
+
+size_t Image::GetLevelSizeBytes(uint32_t level) const
+{
+	return levels[level].sizeBytes;
+}
+
+std::vector<uint8_t> Image::GetLevelRgba(uint32_t level) const
+{
+	auto levelSize = GetLevelSize(level);
+	return PixelConverter::ExpandToRgba(GetLevelPixels(level), format, static_cast<size_t>(levelSize.x) * levelSize.y);
+}
+
+ImageHandle ImageCache::Load(std::string const& path)
+{
+	auto key = NormalizePath(path);
+
+	std::promise<ImageHandle> decoded;
+
+	// Ha már be lett töltve és még a memóriában van, akkor nem kell még egyszer
+	{
+		std::unique_lock lock(mutex);
+		auto it = loadedImages.find(key);
+		if (it != loadedImages.end()) {
+			if (auto image = it->second.image.lock()) {
+				stats.hits++;
+				Touch(it->second, image);
+				return image;
+			}
 		}
+
+		// egy masik szal mar dekodolja, megvarjuk
+		auto pendingIt = pendingImages.find(key);
+		if (pendingIt != pendingImages.end()) {
+			auto pendingImage = pendingIt->second;
+			stats.hits++;
+			lock.unlock();
+			return pendingImage.get();
+		}
+
+		stats.misses++;
+		pendingImages.emplace(key, decoded.get_future().share());
 	}
 
-	// Még nincs betöltve az image, tehát be kell tölteni
-	theLogger.LogInfo("Loading image (stbi): {}", path);
+	// Még nincs betöltve az image (vagy már kikerült), tehát be kell tölteni
+	ImageHandle image;
+	try {
+		image = Decode(key);
+	}
+	catch (...) {
+		// a rank varakozok is megkapjak a hibat, a kovetkezo Load ujra probalkozik
+		{
+			std::lock_guard lock(mutex);
+			pendingImages.erase(key);
+		}
+		decoded.set_exception(std::current_exception());
+		throw;
+	}
 
-	auto image = std::make_unique<Image>();
-	image->path = path;
-	image->data.reset(stbi_load(image->path.c_str(), &image->imageSize.x, &image->imageSize.y, &image->bitPerPixel, STBI_rgb_alpha));
+	{
+		std::lock_guard lock(mutex);
+		auto& entry = loadedImages[key];
+		entry.image = image;
+		Touch(entry, image);
+		pendingImages.erase(key);
 
-	if (!image->data)
-		throw std::runtime_error("stb::stbi_load failed");
+		if (loadedImages.size() >= purgeThreshold) {
+			PurgeExpired();
+		}
+	}
+
+	decoded.set_value(image);
+	return image;
+}
+
+std::vector<ImageHandle> ImageCache::LoadMany(std::vector<std::string> const& paths)
+{
+	// egy path csak egyszer kerul a pool-ra, a tobbi elofordulas ugyanazt a handle-t kapja
+	std::vector<std::string> uniqueKeys;
+	std::vector<size_t> keyIndices;
+	keyIndices.reserve(paths.size());
 
-	loadedImages.push_back(std::move(image));
+	std::unordered_map<std::string, size_t> keyLookup;
+	for (auto const& path : paths) {
+		auto [it, isNew] = keyLookup.emplace(NormalizePath(path), uniqueKeys.size());
+		if (isNew) uniqueKeys.push_back(it->first);
+		keyIndices.push_back(it->second);
+	}
+
+	std::vector<ImageHandle> uniqueImages(uniqueKeys.size());
+	theThreadPool.ParallelFor(uniqueKeys.size(), [&](size_t keyIdx) {
+		uniqueImages[keyIdx] = Load(uniqueKeys[keyIdx]);
+	});
+
+	std::vector<ImageHandle> images;
+	images.reserve(paths.size());
+	for (auto keyIdx : keyIndices) {
+		images.push_back(uniqueImages[keyIdx]);
+	}
 
-	return loadedImages[loadedImages.size() - 1].get();
+	return images;
 }
 
 void ImageCache::Deflate()
 {
-	for (auto& loadedImage : loadedImages) {
-		stbi_image_free(loadedImage.get());
-		loadedImage.release();
+	std::lock_guard lock(mutex);
+	EnforceBudget(0);
+	PurgeExpired();
+}
+
+void ImageCache::SetDiskCacheEnabled(bool isEnabled)
+{
+	diskCacheEnabled = isEnabled;
+}
+
+void ImageCache::SetBudget(size_t newBudgetBytes)
+{
+	std::lock_guard lock(mutex);
+	budgetBytes = newBudgetBytes;
+	EnforceBudget(budgetBytes);
+}
+
+ImageCache::Stats ImageCache::GetStats()
+{
+	std::lock_guard lock(mutex);
+	return stats;
+}
+
+void ImageCache::LogStats()
+{
+	std::lock_guard lock(mutex);
+	auto const& currentStats = stats;
+	theLogger.LogInfo("Image cache: {} images resident ({:.1f} of {:.1f} MB), {} hits, {} misses, {} evictions",
+		currentStats.residentCount, currentStats.residentBytes / (1024.0 * 1024.0), budgetBytes / (1024.0 * 1024.0),
+		currentStats.hits, currentStats.misses, currentStats.evictions);
+}
+
+ImageHandle ImageCache::Decode(std::string const& key)
+{
+	auto useDiskCache = diskCacheEnabled.load();
+
+	if (useDiskCache) {
+		std::shared_ptr<Image> mappedImage;
+		{
+			LoadReport::ScopedPhase phase("images", "diskCacheLoad");
+			mappedImage = ImageDiskCache::TryLoad(key);
+		}
+
+		if (mappedImage) {
+			theLogger.LogInfo("Loading image (mapped): {}", key);
+			theLoadReport.AddCounter("images", "mappedImages", 1);
+			theLoadReport.AddCounter("images", "mappedBytes", mappedImage->GetChainSizeBytes());
+			return mappedImage;
+		}
+	}
+
+	theLogger.LogInfo("Loading image (stbi): {}", key);
+
+	auto image = std::make_shared<Image>();
+	image->path = key;
+
+	// a dekodolas elotti allapot kerul a cache-be, igy egy kozben modositott fajlt a kovetkezo inditas eszrevesz
+	ImageDiskCache::SourceStamp sourceStamp{};
+	if (useDiskCache) {
+		sourceStamp = ImageDiskCache::ReadSourceStamp(key);
+	}
+
+	{
+		LoadReport::ScopedPhase phase("images", "decode");
+
+		// a fajl sajat csatornaszamaval, a szurke maszkok igy negyed annyi memoriat foglalnak
+		int channelCount = 0;
+		image->data.reset(stbi_load(image->path.c_str(), &image->imageSize.x, &image->imageSize.y, &channelCount, 0));
+
+		if (!image->data)
+			throw std::runtime_error("stb::stbi_load failed");
+
+		image->format = PixelConverter::FromChannelCount(channelCount);
+	}
+
+	{
+		LoadReport::ScopedPhase phase("images", "mipGenerate");
+
+		// a mip lanc egyszer keszul el, a feltoltes mar csak masol
+		image->mipLevels = MipGenerator::Generate(image->imageSize, image->data.get(), image->format);
+		image->UpdateLevels();
+	}
+
+	theLoadReport.AddCounter("images", "decodedImages", 1);
+	theLoadReport.AddCounter("images", "decodedBytes", image->GetChainSizeBytes());
+
+	if (useDiskCache) {
+		LoadReport::ScopedPhase phase("images", "diskCacheStore");
+		ImageDiskCache::Store(key, *image, sourceStamp);
 	}
+
+	return image;
+}
+
+std::string ImageCache::NormalizePath(std::string const& path)
+{
+	return fs::path(path).lexically_normal().make_preferred().string();
 }
 
-ImageCache::~ImageCache()
+void ImageCache::Touch(Entry& entry, ImageHandle const& image)
 {
-	Deflate();
+	if (entry.isResident) {
+		residentImages.splice(residentImages.begin(), residentImages, entry.lruIt);
+		return;
+	}
+
+	// egy kiszoritott, de meg hasznalt kep visszakerul a cache-be
+	residentImages.push_front(image);
+	entry.lruIt = residentImages.begin();
+	entry.isResident = true;
+
+	stats.residentCount++;
+	stats.residentBytes += image->GetChainSizeBytes();
+
+	EnforceBudget(budgetBytes);
+}
+
+void ImageCache::EnforceBudget(size_t budget)
+{
+	// a legregebben hasznalt kepek pixelei a handle-ok elengedesevel szabadulnak fel
+	while (stats.residentBytes > budget && !residentImages.empty()) {
+		auto const& image = residentImages.back();
+		loadedImages[image->path].isResident = false;
+
+		stats.residentCount--;
+		stats.residentBytes -= image->GetChainSizeBytes();
+		stats.evictions++;
+
+		residentImages.pop_back();
+	}
+}
+
+void ImageCache::PurgeExpired()
+{
+	std::erase_if(loadedImages, [](auto const& entry) { return entry.second.image.expired(); });
+
+	// a kovetkezo takaritas csak akkor jon, ha a tabla az elo kepek ketszeresere nott
+	purgeThreshold = std::max(minPurgeThreshold, 2 * loadedImages.size());
 }
@@ -1,34 +1,134 @@
 #pragma once
 #include "pch.h"
 
+#include "mapped_file.h"
+#include "pixel_format.h"
+
+// One level of a mip chain, in the format of its image
+struct MipLevel
+{
+	glm::ivec2 size;
+	std::vector<uint8_t> pixels;
+};
+
 struct Image
 {
+	// stbi_load mallocs the pixels, they have to go back through stbi_image_free
+	struct StbiDeleter
+	{
+		void operator()(unsigned char* pixels) const;
+	};
+
+	// One level of the chain, wherever its pixels live
+	struct LevelView
+	{
+		glm::ivec2 size;
+		uint8_t const* pixels;
+		size_t sizeBytes;
+	};
+
 	std::string path;
 
 	glm::ivec2 imageSize;
-	int bitPerPixel = 0;
-	std::unique_ptr<unsigned char> data;
+	// The channel count of the file, the pixels are not expanded on decode
+	PixelFormat format = PixelFormat::RGBA8;
+	std::unique_ptr<unsigned char, StbiDeleter> data;
+	// Levels 1.. of the mip chain, generated once on decode, level 0 is data
+	std::vector<MipLevel> mipLevels;
+	// Set instead of data and mipLevels when the image comes from the disk cache
+	std::unique_ptr<MappedFile> mappedFile;
+	// Every level, pointing into data and mipLevels or into the mapping
+	std::vector<LevelView> levels;
+
+	// Points levels at data and mipLevels, after a decode
+	void UpdateLevels();
+
+	// Level 0 only
+	size_t GetSizeBytes() const;
+	// Every level together, what the image keeps in memory
+	size_t GetChainSizeBytes() const;
+
+	uint32_t GetLevelCount() const;
+	glm::ivec2 GetLevelSize(uint32_t level) const;
+	uint8_t const* GetLevelPixels(uint32_t level) const;
+	size_t GetLevelSizeBytes(uint32_t level) const;
+	// A copy of the level expanded to RGBA8, for the consumers that only take RGBA
+	std::vector<uint8_t> GetLevelRgba(uint32_t level) const;
 };
 
+// Shared ownership of a decoded image, the pixels are freed together with the last handle
+using ImageHandle = std::shared_ptr<Image const>;
+
 struct ImageCache
 {
+	struct Stats
+	{
+		size_t residentCount = 0;
+		uint64_t residentBytes = 0;
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t evictions = 0;
+	};
+
+	static constexpr size_t defaultBudgetBytes = size_t{ 256 } * 1024 * 1024;
+
 	static ImageCache& Instance();
 
 	ImageCache() = default;
-	~ImageCache();
+	~ImageCache() = default;
 
 	ImageCache(ImageCache const&) = delete;
 	ImageCache& operator=(ImageCache const&) = delete;
 	ImageCache(ImageCache&&) = delete;
 	ImageCache& operator=(ImageCache&&) = delete;
 
-	Image* Load(std::string const& path);
+	// Evicted images are decoded again on the next Load, a path being decoded on another thread is waited for
+	ImageHandle Load(std::string const& path);
+	// Decodes the images on the thread pool, returns once all of them are ready (in the order of paths)
+	std::vector<ImageHandle> LoadMany(std::vector<std::string> const& paths);
+	// Evicts every resident image and drops the entries whose images have already been released
 	void Deflate();
 
+	// The CPU memory the cache keeps decoded pixels in, the images still referenced by handles are not counted
+	void SetBudget(size_t budgetBytes);
+	// Decoded chains are mapped from the .imgcache next to the source, a missing or stale one is written after the decode
+	void SetDiskCacheEnabled(bool isEnabled);
+	Stats GetStats();
+	void LogStats();
+
+	// The cache key, different spellings of the same file map to the same entry
+	static std::string NormalizePath(std::string const& path);
+
 private:
 
-	std::vector<std::unique_ptr<Image>> loadedImages;
+	struct Entry
+	{
+		std::weak_ptr<Image const> image;
+		bool isResident = false;
+		std::list<ImageHandle>::iterator lruIt;
+	};
+
+	static constexpr size_t minPurgeThreshold = 64;
+
+	// a modellek a worker szalakon toltodnek be, igy a Load tobb szalrol is johet
+	std::mutex mutex;
+	// a handle-ok mellett csak a residentImages tartja eletben a kepeket
+	std::unordered_map<std::string, Entry> loadedImages;
+	size_t purgeThreshold = minPurgeThreshold;
+	// az eppen dekodolt kepek, hogy ugyanazt a path-ot ket szal ne dekodolja
+	std::unordered_map<std::string, std::shared_future<ImageHandle>> pendingImages;
+
+	// elol a legutobb hasznalt
+	std::list<ImageHandle> residentImages;
+	size_t budgetBytes = defaultBudgetBytes;
+	Stats stats;
+	// a Decode a lock nelkul olvassa
+	std::atomic<bool> diskCacheEnabled = false;
+
+	ImageHandle Decode(std::string const& key);
+	void Touch(Entry& entry, ImageHandle const& image);
+	void EnforceBudget(size_t budget);
+	void PurgeExpired();
 };
 
 inline ImageCache& theImageCache = ImageCache::Instance();
-
@@ -0,0 +1,236 @@
+#include "image_disk_cache.h"
+
+#include "mip_generator.h"
+#include "utils.h"
+
+// a mip generator valtozasakor is novelni kell, kulonben a regi szintek maradnak a cache-ben
+static constexpr std::array<char, 8> imageCacheMagic = { 'M', 'C', 'V', 'K', 'I', 'M', 'G', 'C' };
+static constexpr uint32_t imageCacheVersion = 1;
+static constexpr uint64_t imageCacheAlignment = 16;
+static constexpr uint32_t maxLevelCount = 32;
+
+struct ImageCacheHeader
+{
+	std::array<char, 8> magic;
+	uint32_t version;
+	uint32_t format;
+	uint32_t width;
+	uint32_t height;
+	uint32_t levelCount;
+	uint32_t reserved;
+	uint64_t pathHash;
+	uint64_t sourceSize;
+	int64_t sourceModifiedTime;
+	uint64_t sourceHash;
+};
+
+struct ImageCacheLevel
+{
+	uint64_t offset;
+	uint64_t byteCount;
+	uint32_t width;
+	uint32_t height;
+};
+
+static uint64_t AlignUp(uint64_t offset)
+{
+	return (offset + imageCacheAlignment - 1) & ~(imageCacheAlignment - 1);
+}
+
+static uint64_t HashPath(std::string const& imagePath)
+{
+	return Utils::HashBytes(imagePath.data(), imagePath.size());
+}
+
+static int64_t GetModifiedTime(std::string const& imagePath)
+{
+	return static_cast<int64_t>(fs::last_write_time(imagePath).time_since_epoch().count());
+}
+
+static uint64_t HashSource(std::string const& imagePath)
+{
+	MappedFile sourceFile(imagePath);
+	return Utils::HashBytes(sourceFile.Data(), sourceFile.Size());
+}
+
+// csak a fejlecet irja felul, a szintek es a fajl merete nem valtozik
+static void RewriteHeader(std::string const& cachePath, ImageCacheHeader const& header)
+{
+	std::fstream cacheFile(cachePath, std::ios::in | std::ios::out | std::ios::binary);
+	cacheFile.seekp(0);
+	cacheFile.write(reinterpret_cast<char const*>(&header), sizeof(header));
+	if (!cacheFile) {
+		theLogger.LogWarning("Image cache {} source stamp could not be updated", cachePath);
+		return;
+	}
+
+	theLogger.LogInfo("Image cache {} source stamp updated", cachePath);
+}
+
+std::string ImageDiskCache::GetCachePath(std::string const& imagePath)
+{
+	return imagePath + ".imgcache";
+}
+
+ImageDiskCache::SourceStamp ImageDiskCache::ReadSourceStamp(std::string const& imagePath)
+{
+	SourceStamp sourceStamp;
+	sourceStamp.size = static_cast<uint64_t>(fs::file_size(imagePath));
+	sourceStamp.modifiedTime = GetModifiedTime(imagePath);
+	sourceStamp.contentHash = HashSource(imagePath);
+	return sourceStamp;
+}
+
+std::shared_ptr<Image> ImageDiskCache::TryLoad(std::string const& imagePath)
+{
+	auto cachePath = GetCachePath(imagePath);
+	if (!fs::is_regular_file(cachePath)) {
+		return nullptr;
+	}
+
+	auto reject = [&cachePath](std::string const& reason) -> std::shared_ptr<Image> {
+		theLogger.LogInfo("Image cache {} not used: {}", cachePath, reason);
+		return nullptr;
+	};
+
+	try {
+		auto mappedFile = std::make_unique<MappedFile>(cachePath);
+		auto data = mappedFile->Data();
+		auto size = static_cast<uint64_t>(mappedFile->Size());
+
+		auto isInRange = [size](uint64_t offset, uint64_t byteCount) {
+			return offset <= size && byteCount <= size - offset;
+		};
+
+		if (!isInRange(0, sizeof(ImageCacheHeader))) return reject("truncated header");
+
+		ImageCacheHeader header;
+		std::memcpy(&header, data, sizeof(header));
+
+		if (header.magic != imageCacheMagic) return reject("invalid magic");
+		if (header.version != imageCacheVersion) return reject("outdated format");
+		if (header.pathHash != HashPath(imagePath)) return reject("path changed");
+		if (header.format > static_cast<uint32_t>(PixelFormat::RGBA8)) return reject("invalid format");
+		if (header.width == 0 || header.height == 0) return reject("invalid size");
+
+		// a meret es az ido egyezese eleg, a tartalmat csak akkor hash-eljuk, ha valamelyik elter (pl. checkout utan)
+		auto sourceSize = static_cast<uint64_t>(fs::file_size(imagePath));
+		auto sourceModifiedTime = GetModifiedTime(imagePath);
+		if (header.sourceSize != sourceSize || header.sourceModifiedTime != sourceModifiedTime) {
+			if (header.sourceHash != HashSource(imagePath)) return reject("source changed");
+
+			// a tartalom nem valtozott: az uj meret es ido a fejlecbe kerul, hogy a kovetkezo betoltes ne hash-eljen ujra;
+			// a mapping alatt a fajl nem irhato (Windows), ezert elengedjuk es az iras utan ujra map-eljuk
+			header.sourceSize = sourceSize;
+			header.sourceModifiedTime = sourceModifiedTime;
+			mappedFile.reset();
+			RewriteHeader(cachePath, header);
+			mappedFile = std::make_unique<MappedFile>(cachePath);
+			data = mappedFile->Data();
+			if (static_cast<uint64_t>(mappedFile->Size()) != size) return reject("changed while loading");
+		}
+
+		auto format = static_cast<PixelFormat>(header.format);
+		auto channelCount = static_cast<uint64_t>(PixelConverter::GetChannelCount(format));
+		glm::ivec2 imageSize(header.width, header.height);
+
+		if (header.levelCount != MipGenerator::GetMipCount(imageSize) || header.levelCount > maxLevelCount) return reject("invalid level count");
+
+		uint64_t levelTableOffset = sizeof(ImageCacheHeader);
+		if (!isInRange(levelTableOffset, sizeof(ImageCacheLevel) * header.levelCount)) return reject("truncated level table");
+
+		auto image = std::make_shared<Image>();
+		image->path = imagePath;
+		image->imageSize = imageSize;
+		image->format = format;
+		image->levels.reserve(header.levelCount);
+
+		for (uint32_t levelIdx = 0; levelIdx < header.levelCount; levelIdx++) {
+			ImageCacheLevel entry;
+			std::memcpy(&entry, data + levelTableOffset + sizeof(ImageCacheLevel) * levelIdx, sizeof(entry));
+
+			// a szintek meretet a lanc es a formatum egyertelmuen meghatarozza
+			glm::ivec2 expectedSize = glm::max(glm::ivec2(header.width >> levelIdx, header.height >> levelIdx), glm::ivec2(1));
+			if (entry.width != static_cast<uint32_t>(expectedSize.x) || entry.height != static_cast<uint32_t>(expectedSize.y)) return reject("invalid level size");
+			if (entry.byteCount != channelCount * entry.width * entry.height) return reject("invalid level byte count");
+			if (!isInRange(entry.offset, entry.byteCount)) return reject("truncated level data");
+
+			// nincs masolas, a szint a mapping-be mutat
+			image->levels.push_back(Image::LevelView{ expectedSize, data + entry.offset, static_cast<size_t>(entry.byteCount) });
+		}
+
+		image->mappedFile = std::move(mappedFile);
+		return image;
+	}
+	catch (std::exception& e) {
+		theLogger.LogWarning("Image cache {} could not be read: {}", cachePath, e.what());
+		return nullptr;
+	}
+}
+
+void ImageDiskCache::Store(std::string const& imagePath, Image const& image, SourceStamp const& sourceStamp)
+{
+	if (image.GetLevelCount() == 0) return;
+
+	auto cachePath = GetCachePath(imagePath);
+
+	ImageCacheHeader header{};
+	header.magic = imageCacheMagic;
+	header.version = imageCacheVersion;
+	header.format = static_cast<uint32_t>(image.format);
+	header.width = static_cast<uint32_t>(image.imageSize.x);
+	header.height = static_cast<uint32_t>(image.imageSize.y);
+	header.levelCount = image.GetLevelCount();
+	header.pathHash = HashPath(imagePath);
+	header.sourceSize = sourceStamp.size;
+	header.sourceModifiedTime = sourceStamp.modifiedTime;
+	header.sourceHash = sourceStamp.contentHash;
+
+	std::vector<ImageCacheLevel> levelTable(header.levelCount);
+
+	// eloszor kiosztjuk az offset-eket, utana egyben irjuk ki az egeszet
+	uint64_t fileSize = sizeof(ImageCacheHeader) + sizeof(ImageCacheLevel) * levelTable.size();
+	for (uint32_t levelIdx = 0; levelIdx < header.levelCount; levelIdx++) {
+		auto levelSize = image.GetLevelSize(levelIdx);
+		auto& entry = levelTable[levelIdx];
+		entry.offset = AlignUp(fileSize);
+		entry.byteCount = image.GetLevelSizeBytes(levelIdx);
+		entry.width = static_cast<uint32_t>(levelSize.x);
+		entry.height = static_cast<uint32_t>(levelSize.y);
+		fileSize = entry.offset + entry.byteCount;
+	}
+
+	std::vector<char> buffer(fileSize, 0);
+	std::memcpy(buffer.data(), &header, sizeof(header));
+	std::memcpy(buffer.data() + sizeof(header), levelTable.data(), sizeof(ImageCacheLevel) * levelTable.size());
+
+	for (uint32_t levelIdx = 0; levelIdx < header.levelCount; levelIdx++) {
+		std::memcpy(buffer.data() + levelTable[levelIdx].offset, image.GetLevelPixels(levelIdx), image.GetLevelSizeBytes(levelIdx));
+	}
+
+	// ideiglenes fajlba irunk, hogy egy felbeszakadt iras ne hagyjon hibas cache-t maga utan
+	auto tempPath = cachePath + ".tmp";
+	{
+		std::ofstream ofs(tempPath, std::ios::binary | std::ios::trunc);
+		if (!ofs.is_open()) {
+			theLogger.LogWarning("Image cache {} could not be written", cachePath);
+			return;
+		}
+
+		ofs.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		if (!ofs) {
+			theLogger.LogWarning("Image cache {} could not be written", cachePath);
+			return;
+		}
+	}
+
+	std::error_code errorCode;
+	fs::rename(tempPath, cachePath, errorCode);
+	if (errorCode) {
+		theLogger.LogWarning("Image cache {} could not be written: {}", cachePath, errorCode.message());
+		fs::remove(tempPath, errorCode);
+		return;
+	}
+
+	theLogger.LogInfo("Image cache {} written ({} bytes)", cachePath, buffer.size());
+}
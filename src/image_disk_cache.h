@@ -0,0 +1,24 @@
+#pragma once
+#include "pch.h"
+
+#include "image_cache.h"
+
+// Versioned binary cache of decoded mip chains, stored next to the source image. The levels are
+// laid out so a mapping of the file can be handed to the upload as is, without decoding or copying.
+struct ImageDiskCache
+{
+	// What the cache entry was made from, size and modification time are checked first, the hash only if they differ
+	struct SourceStamp
+	{
+		uint64_t size;
+		int64_t modifiedTime;
+		uint64_t contentHash;
+	};
+
+	static std::string GetCachePath(std::string const& imagePath);
+	static SourceStamp ReadSourceStamp(std::string const& imagePath);
+
+	// The image with its levels pointing into the mapped cache file, nullptr if there is no valid entry
+	static std::shared_ptr<Image> TryLoad(std::string const& imagePath);
+	static void Store(std::string const& imagePath, Image const& image, SourceStamp const& sourceStamp);
+};
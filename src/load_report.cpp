@@ -0,0 +1,122 @@
+#include "load_report.h"
+
+LoadReport::ScopedPhase::ScopedPhase(std::string const& asset, std::string const& phase) :
+	asset{ asset },
+	phase{ phase },
+	start{ std::chrono::high_resolution_clock::now() }
+{
+}
+
+LoadReport::ScopedPhase::~ScopedPhase()
+{
+	auto stop = std::chrono::high_resolution_clock::now();
+	theLoadReport.AddPhaseTime(asset, phase, std::chrono::duration<double, std::milli>(stop - start).count());
+}
+
+LoadReport& LoadReport::Instance()
+{
+	static LoadReport instance;
+	return instance;
+}
+
+void LoadReport::AddPhaseTime(std::string const& asset, std::string const& phase, double ms)
+{
+	std::lock_guard lock(mutex);
+	auto& phases = GetEntry(asset).phases;
+
+	auto it = std::find_if(phases.begin(), phases.end(), [&](auto const& entry) { return entry.first == phase; });
+	if (it == phases.end()) {
+		phases.emplace_back(phase, ms);
+	}
+	else {
+		it->second += ms;
+	}
+}
+
+void LoadReport::AddCounter(std::string const& asset, std::string const& counter, uint64_t value)
+{
+	std::lock_guard lock(mutex);
+	auto& counters = GetEntry(asset).counters;
+
+	auto it = std::find_if(counters.begin(), counters.end(), [&](auto const& entry) { return entry.first == counter; });
+	if (it == counters.end()) {
+		counters.emplace_back(counter, value);
+	}
+	else {
+		it->second += value;
+	}
+}
+
+std::string LoadReport::ToJson()
+{
+	std::lock_guard lock(mutex);
+
+	rapidjson::StringBuffer buffer;
+	rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+
+	writer.StartObject();
+	writer.Key("assets");
+	writer.StartArray();
+
+	for (auto const& entry : entries) {
+		writer.StartObject();
+		writer.Key("name");
+		writer.String(entry.name.c_str());
+
+		writer.Key("phasesMs");
+		writer.StartObject();
+		for (auto const& [phase, ms] : entry.phases) {
+			writer.Key(phase.c_str());
+			writer.Double(ms);
+		}
+		writer.EndObject();
+
+		writer.Key("counters");
+		writer.StartObject();
+		for (auto const& [counter, value] : entry.counters) {
+			writer.Key(counter.c_str());
+			writer.Uint64(value);
+		}
+		writer.EndObject();
+
+		writer.EndObject();
+	}
+
+	writer.EndArray();
+	writer.EndObject();
+
+	return buffer.GetString();
+}
+
+void LoadReport::Write(fs::path const& path)
+{
+	{
+		std::lock_guard lock(mutex);
+		if (written) return;
+		written = true;
+	}
+
+	auto stopTime = std::chrono::high_resolution_clock::now();
+	AddPhaseTime("startup", "wallClock", std::chrono::duration<double, std::milli>(stopTime - startTime).count());
+
+	auto json = ToJson();
+	theLogger.LogInfo("Load report:\n{}", json);
+
+	std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+	if (!ofs) {
+		theLogger.LogWarning("Could not write the load report to {}", path.string());
+		return;
+	}
+
+	ofs << json;
+}
+
+LoadReport::AssetEntry& LoadReport::GetEntry(std::string const& asset)
+{
+	auto it = std::find_if(entries.begin(), entries.end(), [&](auto const& entry) { return entry.name == asset; });
+	if (it != entries.end()) return *it;
+
+	auto& entry = entries.emplace_back();
+	entry.name = asset;
+	return entry;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "pch.h"
+
+// Per-asset load phase timings and sizes, collected from the loader threads and the render thread
+struct LoadReport
+{
+	struct AssetEntry
+	{
+		std::string name;
+		std::vector<std::pair<std::string, double>> phases;		// ms, in first-recorded order
+		std::vector<std::pair<std::string, uint64_t>> counters;
+	};
+
+	// Measures the lifetime of the object and adds it to the given phase
+	struct ScopedPhase
+	{
+		ScopedPhase(std::string const& asset, std::string const& phase);
+		~ScopedPhase();
+
+		ScopedPhase(ScopedPhase const&) = delete;
+		ScopedPhase& operator=(ScopedPhase const&) = delete;
+
+	private:
+		std::string asset;
+		std::string phase;
+		std::chrono::high_resolution_clock::time_point start;
+	};
+
+	static LoadReport& Instance();
+
+	LoadReport() = default;
+
+	LoadReport(LoadReport const&) = delete;
+	LoadReport& operator=(LoadReport const&) = delete;
+	LoadReport(LoadReport&&) = delete;
+	LoadReport& operator=(LoadReport&&) = delete;
+
+	// Both accumulate, so phases split across shapes or threads add up (CPU time, not wall time)
+	void AddPhaseTime(std::string const& asset, std::string const& phase, double ms);
+	void AddCounter(std::string const& asset, std::string const& counter, uint64_t value);
+
+	std::string ToJson();
+	// Writes the report once, later calls are ignored; the time since program start is added as startup/wallClock
+	void Write(fs::path const& path);
+
+private:
+	std::mutex mutex;
+	std::vector<AssetEntry> entries;
+	bool written = false;
+	// a theLoadReport mar a statikus inicializalaskor letrejon, igy ez a program indulasa
+	std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+
+	AssetEntry& GetEntry(std::string const& asset);
+};
+
+inline LoadReport& theLoadReport = LoadReport::Instance();
@@ -0,0 +1,109 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(std::string const& fileName) :
+	data{ nullptr },
+	size{ 0 },
+	fileHandle{ INVALID_HANDLE_VALUE },
+	mappingHandle{ nullptr }
+{
+	fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error(fmt::format("Failed to open file: {}", fileName));
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize)) {
+		CloseHandle(fileHandle);
+		throw std::runtime_error(fmt::format("Failed to query file size: {}", fileName));
+	}
+
+	size = static_cast<size_t>(fileSize.QuadPart);
+
+	// ures fajlt nem lehet mappelni, de nem is kell
+	if (size == 0) return;
+
+	mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mappingHandle) {
+		CloseHandle(fileHandle);
+		throw std::runtime_error(fmt::format("Failed to create file mapping: {}", fileName));
+	}
+
+	data = static_cast<unsigned char const*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (!data) {
+		CloseHandle(mappingHandle);
+		CloseHandle(fileHandle);
+		throw std::runtime_error(fmt::format("Failed to map file: {}", fileName));
+	}
+}
+
+MappedFile::~MappedFile()
+{
+	if (data) UnmapViewOfFile(data);
+	if (mappingHandle) CloseHandle(mappingHandle);
+	if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+}
+
+#else
+
+MappedFile::MappedFile(std::string const& fileName) :
+	data{ nullptr },
+	size{ 0 }
+{
+	auto fd = open(fileName.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw std::runtime_error(fmt::format("Failed to open file: {}", fileName));
+	}
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0) {
+		close(fd);
+		throw std::runtime_error(fmt::format("Failed to query file size: {}", fileName));
+	}
+
+	size = static_cast<size_t>(fileStat.st_size);
+
+	// ures fajlt nem lehet mappelni, de nem is kell
+	if (size == 0) {
+		close(fd);
+		return;
+	}
+
+	auto mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (mapping == MAP_FAILED) {
+		throw std::runtime_error(fmt::format("Failed to map file: {}", fileName));
+	}
+
+	data = static_cast<unsigned char const*>(mapping);
+}
+
+MappedFile::~MappedFile()
+{
+	if (data) munmap(const_cast<unsigned char*>(data), size);
+}
+
+#endif
+
+unsigned char const* MappedFile::Data() const
+{
+	return data;
+}
+
+size_t MappedFile::Size() const
+{
+	return size;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "pch.h"
+
+// Read-only memory mapping of a whole file
+struct MappedFile
+{
+	MappedFile(std::string const& fileName);
+	~MappedFile();
+
+	MappedFile(MappedFile const&) = delete;
+	MappedFile& operator=(MappedFile const&) = delete;
+	MappedFile(MappedFile&&) = delete;
+	MappedFile& operator=(MappedFile&&) = delete;
+
+	unsigned char const* Data() const;
+	size_t Size() const;
+
+private:
+	unsigned char const* data;
+	size_t size;
+
+#ifdef _WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#endif
+};
@@ -0,0 +1,259 @@
+#include "mesh_cache.h"
+
+#include "mapped_file.h"
+
+// A cache fajlban a Vertex-ek binarisan, ugyanabban a formaban vannak mint a memoriaban,
+// ezert minden formatum valtozasnal a meshCacheVersion-t novelni kell
+static_assert(std::is_trivially_copyable_v<Vertex>, "Vertex must be trivially copyable for the mesh cache");
+static_assert(std::is_trivially_copyable_v<Meshlet>, "Meshlet must be trivially copyable for the mesh cache");
+static_assert(std::is_trivially_copyable_v<ShapeLod>, "ShapeLod must be trivially copyable for the mesh cache");
+
+static constexpr std::array<char, 8> meshCacheMagic = { 'M', 'C', 'V', 'K', 'M', 'E', 'S', 'H' };
+static constexpr uint32_t meshCacheVersion = 4;
+static constexpr uint64_t meshCacheAlignment = 16;
+
+struct MeshCacheHeader
+{
+	std::array<char, 8> magic;
+	uint32_t version;
+	uint32_t vertexSize;
+	uint64_t sourceHash;
+	uint64_t settingsHash;
+	uint32_t shapeCount;
+	uint32_t materialCount;
+};
+
+struct MeshCacheShape
+{
+	uint64_t vertexOffset;
+	uint64_t indexOffset;
+	uint32_t vertexCount;
+	uint32_t indexCount;
+	int32_t materialId;
+	uint32_t indexType;
+	uint64_t meshletOffset;
+	uint64_t meshletVertexOffset;
+	uint64_t meshletTriangleOffset;
+	uint32_t meshletCount;
+	uint32_t meshletVertexCount;
+	uint64_t meshletTriangleByteCount;
+	uint64_t lodOffset;
+	uint64_t lodIndexOffset;
+	uint32_t lodCount;
+	uint32_t lodIndexCount;
+};
+
+struct MeshCacheMaterial
+{
+	uint64_t diffuseTextureOffset;
+	uint64_t diffuseTextureLength;
+};
+
+static uint64_t AlignUp(uint64_t offset)
+{
+	return (offset + meshCacheAlignment - 1) & ~(meshCacheAlignment - 1);
+}
+
+std::string MeshCache::GetCachePath(std::string const& modelFileName)
+{
+	return modelFileName + ".meshcache";
+}
+
+std::optional<LoadedModel> MeshCache::TryLoad(std::string const& cachePath, uint64_t sourceHash, uint64_t settingsHash)
+{
+	if (!fs::is_regular_file(cachePath)) {
+		return std::nullopt;
+	}
+
+	auto reject = [&cachePath](std::string const& reason) -> std::optional<LoadedModel> {
+		theLogger.LogInfo("Mesh cache {} not used: {}", cachePath, reason);
+		return std::nullopt;
+	};
+
+	try {
+		MappedFile mappedFile(cachePath);
+		auto data = mappedFile.Data();
+		auto size = static_cast<uint64_t>(mappedFile.Size());
+
+		auto isInRange = [size](uint64_t offset, uint64_t byteCount) {
+			return offset <= size && byteCount <= size - offset;
+		};
+
+		if (!isInRange(0, sizeof(MeshCacheHeader))) return reject("truncated header");
+
+		MeshCacheHeader header;
+		std::memcpy(&header, data, sizeof(header));
+
+		if (header.magic != meshCacheMagic) return reject("invalid magic");
+		if (header.version != meshCacheVersion || header.vertexSize != sizeof(Vertex)) return reject("outdated format");
+		if (header.sourceHash != sourceHash) return reject("source changed");
+		if (header.settingsHash != settingsHash) return reject("load settings changed");
+
+		uint64_t shapeTableOffset = sizeof(MeshCacheHeader);
+		uint64_t materialTableOffset = shapeTableOffset + sizeof(MeshCacheShape) * header.shapeCount;
+		if (!isInRange(shapeTableOffset, sizeof(MeshCacheShape) * header.shapeCount)) return reject("truncated shape table");
+		if (!isInRange(materialTableOffset, sizeof(MeshCacheMaterial) * header.materialCount)) return reject("truncated material table");
+
+		LoadedModel loadedModel;
+		loadedModel.shapes.reserve(header.shapeCount);
+		loadedModel.materials.reserve(header.materialCount);
+
+		for (uint32_t shapeIdx = 0; shapeIdx < header.shapeCount; shapeIdx++) {
+			MeshCacheShape entry;
+			std::memcpy(&entry, data + shapeTableOffset + sizeof(MeshCacheShape) * shapeIdx, sizeof(entry));
+
+			if (!isInRange(entry.vertexOffset, sizeof(Vertex) * entry.vertexCount)) return reject("truncated vertex data");
+			if (!isInRange(entry.indexOffset, sizeof(uint32_t) * entry.indexCount)) return reject("truncated index data");
+			if (entry.materialId < 0 || static_cast<uint32_t>(entry.materialId) >= header.materialCount) return reject("invalid material id");
+			if (entry.indexType > static_cast<uint32_t>(IndexType::UINT32)) return reject("invalid index type");
+			if (entry.indexType == static_cast<uint32_t>(IndexType::UINT16) && entry.vertexCount > std::numeric_limits<uint16_t>::max() + 1u) return reject("index type too narrow");
+			if (!isInRange(entry.meshletOffset, sizeof(Meshlet) * entry.meshletCount)) return reject("truncated meshlet data");
+			if (!isInRange(entry.meshletVertexOffset, sizeof(uint32_t) * entry.meshletVertexCount)) return reject("truncated meshlet vertex data");
+			if (!isInRange(entry.meshletTriangleOffset, entry.meshletTriangleByteCount)) return reject("truncated meshlet triangle data");
+			if (!isInRange(entry.lodOffset, sizeof(ShapeLod) * entry.lodCount)) return reject("truncated lod data");
+			if (!isInRange(entry.lodIndexOffset, sizeof(uint32_t) * entry.lodIndexCount)) return reject("truncated lod index data");
+
+			// az offset-ek 16 byte-ra, a mapping laphatarra igazitott, igy a tombok kiolvasasa egy-egy masolas;
+			// a mapping a betoltes vegen megszunik, ezert a shape sajat vektorokba kapja az adatot
+			auto vertexBegin = reinterpret_cast<Vertex const*>(data + entry.vertexOffset);
+			auto indexBegin = reinterpret_cast<uint32_t const*>(data + entry.indexOffset);
+
+			auto& shape = loadedModel.shapes.emplace_back();
+			shape.vertices.assign(vertexBegin, vertexBegin + entry.vertexCount);
+			shape.indices.assign(indexBegin, indexBegin + entry.indexCount);
+			shape.materialId = entry.materialId;
+			shape.indexType = static_cast<IndexType>(entry.indexType);
+
+			auto meshletBegin = reinterpret_cast<Meshlet const*>(data + entry.meshletOffset);
+			auto meshletVertexBegin = reinterpret_cast<uint32_t const*>(data + entry.meshletVertexOffset);
+			auto meshletTriangleBegin = data + entry.meshletTriangleOffset;
+			shape.meshlets.assign(meshletBegin, meshletBegin + entry.meshletCount);
+			shape.meshletVertices.assign(meshletVertexBegin, meshletVertexBegin + entry.meshletVertexCount);
+			shape.meshletTriangles.assign(meshletTriangleBegin, meshletTriangleBegin + entry.meshletTriangleByteCount);
+
+			auto lodBegin = reinterpret_cast<ShapeLod const*>(data + entry.lodOffset);
+			auto lodIndexBegin = reinterpret_cast<uint32_t const*>(data + entry.lodIndexOffset);
+			shape.lods.assign(lodBegin, lodBegin + entry.lodCount);
+			shape.lodIndices.assign(lodIndexBegin, lodIndexBegin + entry.lodIndexCount);
+
+			for (auto const& lod : shape.lods) {
+				if (static_cast<uint64_t>(lod.indexOffset) + lod.indexCount > entry.lodIndexCount) return reject("invalid lod range");
+			}
+		}
+
+		for (uint32_t materialIdx = 0; materialIdx < header.materialCount; materialIdx++) {
+			MeshCacheMaterial entry;
+			std::memcpy(&entry, data + materialTableOffset + sizeof(MeshCacheMaterial) * materialIdx, sizeof(entry));
+
+			if (!isInRange(entry.diffuseTextureOffset, entry.diffuseTextureLength)) return reject("truncated material data");
+
+			auto diffuseTextureBegin = reinterpret_cast<char const*>(data + entry.diffuseTextureOffset);
+			loadedModel.materials.emplace_back(std::string(diffuseTextureBegin, entry.diffuseTextureLength));
+		}
+
+		return loadedModel;
+	}
+	catch (std::exception& e) {
+		theLogger.LogWarning("Mesh cache {} could not be read: {}", cachePath, e.what());
+		return std::nullopt;
+	}
+}
+
+void MeshCache::Store(std::string const& cachePath, LoadedModel const& loadedModel, uint64_t sourceHash, uint64_t settingsHash)
+{
+	MeshCacheHeader header{};
+	header.magic = meshCacheMagic;
+	header.version = meshCacheVersion;
+	header.vertexSize = sizeof(Vertex);
+	header.sourceHash = sourceHash;
+	header.settingsHash = settingsHash;
+	header.shapeCount = static_cast<uint32_t>(loadedModel.shapes.size());
+	header.materialCount = static_cast<uint32_t>(loadedModel.materials.size());
+
+	std::vector<MeshCacheShape> shapeTable(loadedModel.shapes.size());
+	std::vector<MeshCacheMaterial> materialTable(loadedModel.materials.size());
+
+	// eloszor kiosztjuk az offset-eket, utana egyben irjuk ki az egeszet
+	uint64_t fileSize = sizeof(MeshCacheHeader) + sizeof(MeshCacheShape) * shapeTable.size() + sizeof(MeshCacheMaterial) * materialTable.size();
+	auto allocate = [&fileSize](uint64_t byteCount) {
+		auto offset = AlignUp(fileSize);
+		fileSize = offset + byteCount;
+		return offset;
+	};
+
+	for (size_t shapeIdx = 0; shapeIdx < loadedModel.shapes.size(); shapeIdx++) {
+		auto const& shape = loadedModel.shapes[shapeIdx];
+		auto& entry = shapeTable[shapeIdx];
+		entry.vertexCount = static_cast<uint32_t>(shape.vertices.size());
+		entry.indexCount = static_cast<uint32_t>(shape.indices.size());
+		entry.materialId = shape.materialId;
+		entry.indexType = static_cast<uint32_t>(shape.indexType);
+		entry.vertexOffset = allocate(sizeof(Vertex) * shape.vertices.size());
+		entry.indexOffset = allocate(sizeof(uint32_t) * shape.indices.size());
+		entry.meshletCount = static_cast<uint32_t>(shape.meshlets.size());
+		entry.meshletVertexCount = static_cast<uint32_t>(shape.meshletVertices.size());
+		entry.meshletTriangleByteCount = shape.meshletTriangles.size();
+		entry.meshletOffset = allocate(sizeof(Meshlet) * shape.meshlets.size());
+		entry.meshletVertexOffset = allocate(sizeof(uint32_t) * shape.meshletVertices.size());
+		entry.meshletTriangleOffset = allocate(shape.meshletTriangles.size());
+		entry.lodCount = static_cast<uint32_t>(shape.lods.size());
+		entry.lodIndexCount = static_cast<uint32_t>(shape.lodIndices.size());
+		entry.lodOffset = allocate(sizeof(ShapeLod) * shape.lods.size());
+		entry.lodIndexOffset = allocate(sizeof(uint32_t) * shape.lodIndices.size());
+	}
+
+	for (size_t materialIdx = 0; materialIdx < loadedModel.materials.size(); materialIdx++) {
+		auto const& material = loadedModel.materials[materialIdx];
+		auto& entry = materialTable[materialIdx];
+		entry.diffuseTextureLength = material.diffuseTexture.size();
+		entry.diffuseTextureOffset = allocate(material.diffuseTexture.size());
+	}
+
+	std::vector<char> buffer(fileSize, 0);
+	std::memcpy(buffer.data(), &header, sizeof(header));
+	std::memcpy(buffer.data() + sizeof(header), shapeTable.data(), sizeof(MeshCacheShape) * shapeTable.size());
+	std::memcpy(buffer.data() + sizeof(header) + sizeof(MeshCacheShape) * shapeTable.size(), materialTable.data(), sizeof(MeshCacheMaterial) * materialTable.size());
+
+	for (size_t shapeIdx = 0; shapeIdx < loadedModel.shapes.size(); shapeIdx++) {
+		auto const& shape = loadedModel.shapes[shapeIdx];
+		auto const& entry = shapeTable[shapeIdx];
+		std::memcpy(buffer.data() + entry.vertexOffset, shape.vertices.data(), sizeof(Vertex) * shape.vertices.size());
+		std::memcpy(buffer.data() + entry.indexOffset, shape.indices.data(), sizeof(uint32_t) * shape.indices.size());
+		std::memcpy(buffer.data() + entry.meshletOffset, shape.meshlets.data(), sizeof(Meshlet) * shape.meshlets.size());
+		std::memcpy(buffer.data() + entry.meshletVertexOffset, shape.meshletVertices.data(), sizeof(uint32_t) * shape.meshletVertices.size());
+		std::memcpy(buffer.data() + entry.meshletTriangleOffset, shape.meshletTriangles.data(), shape.meshletTriangles.size());
+		std::memcpy(buffer.data() + entry.lodOffset, shape.lods.data(), sizeof(ShapeLod) * shape.lods.size());
+		std::memcpy(buffer.data() + entry.lodIndexOffset, shape.lodIndices.data(), sizeof(uint32_t) * shape.lodIndices.size());
+	}
+
+	for (size_t materialIdx = 0; materialIdx < loadedModel.materials.size(); materialIdx++) {
+		auto const& material = loadedModel.materials[materialIdx];
+		std::memcpy(buffer.data() + materialTable[materialIdx].diffuseTextureOffset, material.diffuseTexture.data(), material.diffuseTexture.size());
+	}
+
+	// ideiglenes fajlba irunk, hogy egy felbeszakadt iras ne hagyjon hibas cache-t maga utan
+	auto tempPath = cachePath + ".tmp";
+	{
+		std::ofstream ofs(tempPath, std::ios::binary | std::ios::trunc);
+		if (!ofs.is_open()) {
+			theLogger.LogWarning("Mesh cache {} could not be written", cachePath);
+			return;
+		}
+
+		ofs.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		if (!ofs) {
+			theLogger.LogWarning("Mesh cache {} could not be written", cachePath);
+			return;
+		}
+	}
+
+	std::error_code errorCode;
+	fs::rename(tempPath, cachePath, errorCode);
+	if (errorCode) {
+		theLogger.LogWarning("Mesh cache {} could not be written: {}", cachePath, errorCode.message());
+		fs::remove(tempPath, errorCode);
+		return;
+	}
+
+	theLogger.LogInfo("Mesh cache {} written ({} bytes)", cachePath, buffer.size());
+}
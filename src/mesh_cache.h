@@ -0,0 +1,12 @@
+#pragma once
+#include "pch.h"
+
+#include "model_loader.h"
+
+// Versioned binary cache of a finished LoadedModel, stored next to the source model
+struct MeshCache
+{
+	static std::string GetCachePath(std::string const& modelFileName);
+	static std::optional<LoadedModel> TryLoad(std::string const& cachePath, uint64_t sourceHash, uint64_t settingsHash);
+	static void Store(std::string const& cachePath, LoadedModel const& loadedModel, uint64_t sourceHash, uint64_t settingsHash);
+};
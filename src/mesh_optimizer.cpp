@@ -0,0 +1,315 @@
+#include "mesh_optimizer.h"
+
+static constexpr uint32_t invalidIndex = std::numeric_limits<uint32_t>::max();
+
+// Forsyth: "Linear-Speed Vertex Cache Optimisation" alapertelmezett parameterei
+static constexpr int forsythCacheSize = 32;
+static constexpr float forsythCacheDecayPower = 1.5f;
+static constexpr float forsythLastTriangleScore = 0.75f;
+static constexpr float forsythValenceBoostScale = 2.0f;
+static constexpr float forsythValenceBoostPower = 0.5f;
+
+static float ForsythVertexScore(int cachePosition, uint32_t remainingTriangles)
+{
+	// mar nincs hozza tartozo haromszog, nem is erdekes
+	if (remainingTriangles == 0) return -1.0f;
+
+	float score = 0.0f;
+
+	if (cachePosition >= 0) {
+		if (cachePosition < 3) {
+			// az utolso haromszog csucsai szandekosan alacsonyabb pontot kapnak,
+			// kulonben mindig ugyanazt a ket csucsot hasznalnank ujra
+			score = forsythLastTriangleScore;
+		}
+		else {
+			auto scaler = 1.0f / (forsythCacheSize - 3);
+			score = std::pow(1.0f - (cachePosition - 3) * scaler, forsythCacheDecayPower);
+		}
+	}
+
+	// a keves hatralevo haromszoggel rendelkezo csucsokat erdemes minel hamarabb lezarni
+	score += forsythValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -forsythValenceBoostPower);
+
+	return score;
+}
+
+float MeshOptimizer::CacheStats::Acmr() const
+{
+	return triangleCount > 0 ? static_cast<float>(misses) / triangleCount : 0.0f;
+}
+
+float MeshOptimizer::CacheStats::Atvr() const
+{
+	return vertexCount > 0 ? static_cast<float>(misses) / vertexCount : 0.0f;
+}
+
+MeshOptimizer::CacheStats& MeshOptimizer::CacheStats::operator+=(CacheStats const& other)
+{
+	misses += other.misses;
+	triangleCount += other.triangleCount;
+	vertexCount += other.vertexCount;
+	return *this;
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount)
+{
+	auto triangleCount = indices.size() / 3;
+	if (triangleCount == 0) return;
+
+	// csucs -> haromszog szomszedsag egyetlen tombben (offset + darabszam csucsonkent)
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+	for (auto index : indices) {
+		adjacencyOffsets[index + 1]++;
+	}
+
+	for (size_t vertexIdx = 0; vertexIdx < vertexCount; vertexIdx++) {
+		adjacencyOffsets[vertexIdx + 1] += adjacencyOffsets[vertexIdx];
+	}
+
+	std::vector<uint32_t> adjacency(indices.size());
+	std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+	for (size_t triangleIdx = 0; triangleIdx < triangleCount; triangleIdx++) {
+		for (size_t corner = 0; corner < 3; corner++) {
+			auto vertexIdx = indices[triangleIdx * 3 + corner];
+			adjacency[adjacencyOffsets[vertexIdx] + remainingTriangles[vertexIdx]++] = static_cast<uint32_t>(triangleIdx);
+		}
+	}
+
+	std::vector<int> cachePositions(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	for (size_t vertexIdx = 0; vertexIdx < vertexCount; vertexIdx++) {
+		vertexScores[vertexIdx] = ForsythVertexScore(-1, remainingTriangles[vertexIdx]);
+	}
+
+	auto triangleScore = [&](uint32_t triangleIdx) {
+		return vertexScores[indices[triangleIdx * 3 + 0]]
+			+ vertexScores[indices[triangleIdx * 3 + 1]]
+			+ vertexScores[indices[triangleIdx * 3 + 2]];
+	};
+
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+
+	std::vector<uint32_t> cache, newCache;
+	cache.reserve(forsythCacheSize + 3);
+	newCache.reserve(forsythCacheSize + 3);
+
+	// kezdetben a legjobb pontszamu haromszoggel indulunk
+	uint32_t bestTriangle = 0;
+	float bestScore = triangleScore(0);
+	for (uint32_t triangleIdx = 1; triangleIdx < triangleCount; triangleIdx++) {
+		auto score = triangleScore(triangleIdx);
+		if (score > bestScore) {
+			bestScore = score;
+			bestTriangle = triangleIdx;
+		}
+	}
+
+	size_t deadEndCursor = 0;
+
+	while (result.size() < indices.size()) {
+		if (bestTriangle == invalidIndex) {
+			// zsakutca: a cache-ben levo csucsoknak nincs tobb haromszoge, az elso meg ki nem adottal folytatjuk
+			while (emitted[deadEndCursor]) deadEndCursor++;
+			bestTriangle = static_cast<uint32_t>(deadEndCursor);
+		}
+
+		emitted[bestTriangle] = true;
+
+		std::array<uint32_t, 3> triangle = {
+			indices[bestTriangle * 3 + 0],
+			indices[bestTriangle * 3 + 1],
+			indices[bestTriangle * 3 + 2]
+		};
+
+		for (auto vertexIdx : triangle) {
+			result.push_back(vertexIdx);
+
+			// a kiadott haromszoget kivesszuk a csucs szomszedsagabol
+			auto begin = adjacency.begin() + adjacencyOffsets[vertexIdx];
+			auto end = begin + remainingTriangles[vertexIdx];
+			auto it = std::find(begin, end, bestTriangle);
+			if (it != end) {
+				std::iter_swap(it, end - 1);
+				remainingTriangles[vertexIdx]--;
+			}
+		}
+
+		// LRU cache frissites: a haromszog csucsai kerulnek elore
+		newCache.assign(triangle.begin(), triangle.end());
+		for (auto vertexIdx : cache) {
+			if (vertexIdx != triangle[0] && vertexIdx != triangle[1] && vertexIdx != triangle[2]) {
+				newCache.push_back(vertexIdx);
+			}
+		}
+
+		for (size_t position = 0; position < newCache.size(); position++) {
+			auto vertexIdx = newCache[position];
+			auto cachePosition = position < forsythCacheSize ? static_cast<int>(position) : -1;
+			cachePositions[vertexIdx] = cachePosition;
+			vertexScores[vertexIdx] = ForsythVertexScore(cachePosition, remainingTriangles[vertexIdx]);
+		}
+
+		if (newCache.size() > forsythCacheSize) {
+			newCache.resize(forsythCacheSize);
+		}
+
+		std::swap(cache, newCache);
+
+		// kovetkezo jelolt: a cache-ben levo csucsok meg ki nem adott haromszogei kozul a legjobb
+		bestTriangle = invalidIndex;
+		bestScore = -1.0f;
+		for (auto vertexIdx : cache) {
+			auto begin = adjacencyOffsets[vertexIdx];
+			auto end = begin + remainingTriangles[vertexIdx];
+			for (auto adjacencyIdx = begin; adjacencyIdx < end; adjacencyIdx++) {
+				auto triangleIdx = adjacency[adjacencyIdx];
+				auto score = triangleScore(triangleIdx);
+				if (score > bestScore) {
+					bestScore = score;
+					bestTriangle = triangleIdx;
+				}
+			}
+		}
+	}
+
+	indices = std::move(result);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t>& indices, std::vector<Vertex> const& vertices)
+{
+	auto triangleCount = indices.size() / 3;
+	if (triangleCount == 0) return;
+
+	// Klaszterek: ott vagjuk el a haromszog sorozatot, ahol egy haromszog mindharom csucsa cache miss,
+	// mert ott a vertex cache ugyis ujraindul, igy a klaszterek atrendezese nem rontja az ACMR-t
+	std::vector<size_t> clusterStarts;
+	std::vector<uint32_t> timestamps(vertices.size(), 0);
+	uint32_t time = analyzeCacheSize + 1;
+
+	for (size_t triangleIdx = 0; triangleIdx < triangleCount; triangleIdx++) {
+		int misses = 0;
+		for (size_t corner = 0; corner < 3; corner++) {
+			auto vertexIdx = indices[triangleIdx * 3 + corner];
+			if (time - timestamps[vertexIdx] > analyzeCacheSize) {
+				timestamps[vertexIdx] = time++;
+				misses++;
+			}
+		}
+
+		if (triangleIdx == 0 || misses == 3) {
+			clusterStarts.push_back(triangleIdx);
+		}
+	}
+
+	clusterStarts.push_back(triangleCount);
+
+	struct Cluster
+	{
+		size_t firstTriangle, triangleCount;
+		glm::vec3 centroid, normal;
+		float area;
+		float sortKey;
+	};
+
+	std::vector<Cluster> clusters;
+	clusters.reserve(clusterStarts.size() - 1);
+
+	glm::vec3 meshCentroid{ 0.0f, 0.0f, 0.0f };
+	float meshArea = 0.0f;
+
+	for (size_t clusterIdx = 0; clusterIdx + 1 < clusterStarts.size(); clusterIdx++) {
+		Cluster cluster{};
+		cluster.firstTriangle = clusterStarts[clusterIdx];
+		cluster.triangleCount = clusterStarts[clusterIdx + 1] - clusterStarts[clusterIdx];
+		cluster.centroid = glm::vec3{ 0.0f, 0.0f, 0.0f };
+		cluster.normal = glm::vec3{ 0.0f, 0.0f, 0.0f };
+
+		// teruletsulyozott kozeppont es normalis
+		for (auto triangleIdx = cluster.firstTriangle; triangleIdx < cluster.firstTriangle + cluster.triangleCount; triangleIdx++) {
+			auto const& a = vertices[indices[triangleIdx * 3 + 0]].pos;
+			auto const& b = vertices[indices[triangleIdx * 3 + 1]].pos;
+			auto const& c = vertices[indices[triangleIdx * 3 + 2]].pos;
+
+			auto triangleNormal = glm::cross(b - a, c - a);
+			auto triangleArea = glm::length(triangleNormal) * 0.5f;
+
+			cluster.centroid += (a + b + c) * (triangleArea / 3.0f);
+			cluster.normal += triangleNormal;
+			cluster.area += triangleArea;
+		}
+
+		meshCentroid += cluster.centroid;
+		meshArea += cluster.area;
+
+		if (cluster.area > 0.0f) {
+			cluster.centroid /= cluster.area;
+		}
+
+		clusters.push_back(cluster);
+	}
+
+	if (meshArea > 0.0f) {
+		meshCentroid /= meshArea;
+	}
+
+	// a kifele nezo klaszterek kerulnek elore, mert azok takarjak el a tobbit
+	for (auto& cluster : clusters) {
+		auto normalLength = glm::length(cluster.normal);
+		auto direction = normalLength > 0.0f ? cluster.normal / normalLength : glm::vec3{ 0.0f, 0.0f, 0.0f };
+		cluster.sortKey = glm::dot(cluster.centroid - meshCentroid, direction);
+	}
+
+	std::stable_sort(clusters.begin(), clusters.end(), [](Cluster const& lhs, Cluster const& rhs) {
+		return lhs.sortKey > rhs.sortKey;
+	});
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+	for (auto const& cluster : clusters) {
+		auto begin = indices.begin() + cluster.firstTriangle * 3;
+		result.insert(result.end(), begin, begin + cluster.triangleCount * 3);
+	}
+
+	indices = std::move(result);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+	std::vector<uint32_t> remap(vertices.size(), invalidIndex);
+	std::vector<Vertex> newVertices;
+	newVertices.reserve(vertices.size());
+
+	for (auto& index : indices) {
+		if (remap[index] == invalidIndex) {
+			remap[index] = static_cast<uint32_t>(newVertices.size());
+			newVertices.push_back(vertices[index]);
+		}
+
+		index = remap[index];
+	}
+
+	vertices = std::move(newVertices);
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::AnalyzeVertexCache(std::vector<uint32_t> const& indices, size_t vertexCount, uint32_t cacheSize)
+{
+	CacheStats stats;
+	stats.triangleCount = indices.size() / 3;
+	stats.vertexCount = vertexCount;
+
+	// FIFO cache idobelyegekkel: egy csucs akkor van benne, ha azota legfeljebb cacheSize miss volt
+	std::vector<uint32_t> timestamps(vertexCount, 0);
+	uint32_t time = cacheSize + 1;
+
+	for (auto index : indices) {
+		if (time - timestamps[index] > cacheSize) {
+			timestamps[index] = time++;
+			stats.misses++;
+		}
+	}
+
+	return stats;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "pch.h"
+
+#include "model_loader.h"
+
+// Post-load index/vertex reordering passes, all of them keep the triangle winding
+struct MeshOptimizer
+{
+	struct CacheStats
+	{
+		size_t misses = 0;
+		size_t triangleCount = 0;
+		size_t vertexCount = 0;
+
+		// average cache miss ratio: transformed vertices per triangle (0.5 is the ideal for large meshes)
+		float Acmr() const;
+		// average transform to vertex ratio: transformed vertices per unique vertex (1.0 is the ideal)
+		float Atvr() const;
+
+		CacheStats& operator+=(CacheStats const& other);
+	};
+
+	static constexpr uint32_t analyzeCacheSize = 16;
+
+	// Forsyth's linear-speed vertex cache optimisation
+	static void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+	// Sorts cache-coherent triangle clusters so that outward-facing ones are drawn first
+	static void OptimizeOverdraw(std::vector<uint32_t>& indices, std::vector<Vertex> const& vertices);
+	// Renumbers the vertices in first-use order, unreferenced vertices are dropped
+	static void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+	// Simulates a FIFO post-transform cache
+	static CacheStats AnalyzeVertexCache(std::vector<uint32_t> const& indices, size_t vertexCount, uint32_t cacheSize = analyzeCacheSize);
+};
@@ -0,0 +1,246 @@
+#include "mesh_simplifier.h"
+
+// Az ax + by + cz + d = 0 sikoktol mert negyzetes tavolsagok sulyozott osszege, szimmetrikus 4x4-es matrixkent
+struct Quadric
+{
+	double a2 = 0.0, ab = 0.0, ac = 0.0, ad = 0.0;
+	double b2 = 0.0, bc = 0.0, bd = 0.0;
+	double c2 = 0.0, cd = 0.0;
+	double d2 = 0.0;
+	double weight = 0.0;
+
+	static Quadric FromPlane(glm::vec3 const& normal, float distance, float weight)
+	{
+		double a = normal.x, b = normal.y, c = normal.z, d = distance;
+
+		Quadric quadric;
+		quadric.a2 = a * a * weight; quadric.ab = a * b * weight; quadric.ac = a * c * weight; quadric.ad = a * d * weight;
+		quadric.b2 = b * b * weight; quadric.bc = b * c * weight; quadric.bd = b * d * weight;
+		quadric.c2 = c * c * weight; quadric.cd = c * d * weight;
+		quadric.d2 = d * d * weight;
+		quadric.weight = weight;
+
+		return quadric;
+	}
+
+	Quadric& operator+=(Quadric const& other)
+	{
+		a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+		b2 += other.b2; bc += other.bc; bd += other.bd;
+		c2 += other.c2; cd += other.cd;
+		d2 += other.d2;
+		weight += other.weight;
+
+		return *this;
+	}
+
+	// a sulyok atlaga, igy az eredmeny egy negyzetes tavolsag, fuggetlenul a haromszogek teruletetol
+	double Evaluate(glm::vec3 const& point) const
+	{
+		double x = point.x, y = point.y, z = point.z;
+
+		auto error = a2 * x * x + b2 * y * y + c2 * z * z
+			+ 2.0 * (ab * x * y + ac * x * z + bc * y * z)
+			+ 2.0 * (ad * x + bd * y + cd * z)
+			+ d2;
+
+		return weight > 0.0 ? std::abs(error) / weight : 0.0;
+	}
+};
+
+struct Collapse
+{
+	uint32_t from, to;
+	double cost;
+};
+
+static uint64_t EdgeKey(uint32_t from, uint32_t to)
+{
+	return (static_cast<uint64_t>(from) << 32) | to;
+}
+
+std::vector<uint32_t> MeshSimplifier::Simplify(std::vector<Vertex> const& vertices, std::vector<uint32_t> const& indices, size_t targetIndexCount, float maxError, float& resultError)
+{
+	resultError = 0.0f;
+
+	if (indices.size() % 3 != 0) throw std::runtime_error("index count not matching");
+
+	auto vertexCount = static_cast<uint32_t>(vertices.size());
+
+	// az azonos poziciora eso vertex-ek (UV varrat) egy kozos "pozicio vertex"-et kapnak
+	std::vector<uint32_t> positionRemap(vertexCount);
+	std::vector<uint32_t> wedgeCount(vertexCount, 0);
+	{
+		std::unordered_map<glm::vec3, uint32_t> firstVertex;
+		firstVertex.reserve(vertexCount);
+
+		for (uint32_t v = 0; v < vertexCount; v++) {
+			auto it = firstVertex.try_emplace(vertices[v].pos, v).first;
+			positionRemap[v] = it->second;
+			wedgeCount[it->second]++;
+		}
+	}
+
+	// a varrat es a nyitott perem vertex-ei nem mozdulhatnak
+	std::vector<uint8_t> isLocked(vertexCount, 0);
+	{
+		std::unordered_set<uint64_t> edges;
+		edges.reserve(indices.size());
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			for (int e = 0; e < 3; e++) {
+				edges.insert(EdgeKey(positionRemap[indices[i + e]], positionRemap[indices[i + (e + 1) % 3]]));
+			}
+		}
+
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			for (int e = 0; e < 3; e++) {
+				auto from = positionRemap[indices[i + e]];
+				auto to = positionRemap[indices[i + (e + 1) % 3]];
+				if (edges.count(EdgeKey(to, from)) == 0) {
+					isLocked[from] = 1;
+					isLocked[to] = 1;
+				}
+			}
+		}
+
+		for (uint32_t v = 0; v < vertexCount; v++) {
+			if (wedgeCount[positionRemap[v]] > 1) isLocked[positionRemap[v]] = 1;
+		}
+	}
+
+	auto const& pos = [&](uint32_t v) -> glm::vec3 const& { return vertices[v].pos; };
+
+	std::vector<Quadric> quadrics(vertexCount);
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		auto normal = glm::cross(pos(indices[i + 1]) - pos(indices[i]), pos(indices[i + 2]) - pos(indices[i]));
+		auto area = glm::length(normal);
+		if (area <= 0.0f) continue;
+
+		normal /= area;
+		auto quadric = Quadric::FromPlane(normal, -glm::dot(normal, pos(indices[i])), area);
+		for (int k = 0; k < 3; k++) {
+			quadrics[positionRemap[indices[i + k]]] += quadric;
+		}
+	}
+
+	auto maxCost = static_cast<double>(maxError) * maxError;
+	double resultCost = 0.0;
+
+	std::vector<uint32_t> result = indices;
+	std::vector<uint32_t> remap(vertexCount);
+	std::vector<uint8_t> isTouched(vertexCount);
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+	std::vector<uint32_t> adjacency;
+	std::vector<Collapse> collapses;
+
+	static constexpr int maxPasses = 64;
+	for (int pass = 0; pass < maxPasses && result.size() > targetIndexCount; pass++) {
+		// vertex -> haromszogek (CSR)
+		std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+		for (auto index : result) adjacencyOffsets[index + 1]++;
+		for (uint32_t v = 0; v < vertexCount; v++) adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+
+		adjacency.resize(result.size());
+		{
+			auto fillOffsets = adjacencyOffsets;
+			for (size_t i = 0; i < result.size(); i++) {
+				adjacency[fillOffsets[result[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		// a from vertex a to-ba olvad, csak nem rogzitett from lehet
+		collapses.clear();
+		for (size_t i = 0; i < result.size(); i += 3) {
+			for (int e = 0; e < 3; e++) {
+				auto v0 = result[i + e];
+				auto v1 = result[i + (e + 1) % 3];
+
+				for (auto [from, to] : { std::pair{ v0, v1 }, std::pair{ v1, v0 } }) {
+					if (isLocked[positionRemap[from]]) continue;
+
+					auto quadric = quadrics[positionRemap[from]];
+					quadric += quadrics[positionRemap[to]];
+					collapses.push_back(Collapse{ from, to, quadric.Evaluate(pos(to)) });
+				}
+			}
+		}
+
+		std::sort(collapses.begin(), collapses.end(), [](Collapse const& lhs, Collapse const& rhs) {
+			if (lhs.cost != rhs.cost) return lhs.cost < rhs.cost;
+			return EdgeKey(lhs.from, lhs.to) < EdgeKey(rhs.from, rhs.to);
+		});
+
+		std::iota(remap.begin(), remap.end(), 0);
+		std::fill(isTouched.begin(), isTouched.end(), 0);
+
+		auto triangleCount = result.size() / 3;
+		auto targetTriangleCount = targetIndexCount / 3;
+		size_t collapseCount = 0;
+
+		for (auto const& collapse : collapses) {
+			if (collapse.cost > maxCost || triangleCount <= targetTriangleCount) break;
+			if (isTouched[positionRemap[collapse.from]] || isTouched[positionRemap[collapse.to]]) continue;
+
+			auto triangles = adjacency.data() + adjacencyOffsets[collapse.from];
+			auto trianglesEnd = adjacency.data() + adjacencyOffsets[collapse.from + 1];
+
+			// a megmarado haromszogek nem fordulhatnak at
+			bool isFlipping = false;
+			size_t removedTriangles = 0;
+			for (auto it = triangles; it != trianglesEnd && !isFlipping; it++) {
+				auto t = result.data() + 3 * *it;
+				if (t[0] == collapse.to || t[1] == collapse.to || t[2] == collapse.to) {
+					removedTriangles++;
+					continue;
+				}
+
+				std::array<glm::vec3, 3> before = { pos(t[0]), pos(t[1]), pos(t[2]) };
+				auto after = before;
+				for (int k = 0; k < 3; k++) {
+					if (t[k] == collapse.from) after[k] = pos(collapse.to);
+				}
+
+				auto normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+				auto normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+				isFlipping = glm::dot(normalBefore, normalAfter) <= 0.0f;
+			}
+
+			if (isFlipping) continue;
+
+			remap[collapse.from] = collapse.to;
+			quadrics[positionRemap[collapse.to]] += quadrics[positionRemap[collapse.from]];
+			resultCost = std::max(resultCost, collapse.cost);
+			triangleCount -= std::min(triangleCount, removedTriangles);
+			collapseCount++;
+
+			// a from egy-gyuruje ebben a korben mar nem valtozhat, kulonben a fenti ellenorzes elavulna
+			isTouched[positionRemap[collapse.to]] = 1;
+			for (auto it = triangles; it != trianglesEnd; it++) {
+				for (int k = 0; k < 3; k++) {
+					isTouched[positionRemap[result[3 * *it + k]]] = 1;
+				}
+			}
+		}
+
+		if (collapseCount == 0) break;
+
+		// egy korben nincs lancolt osszevonas, igy eleg egy lepes a remap-ben
+		size_t writeIdx = 0;
+		for (size_t i = 0; i < result.size(); i += 3) {
+			std::array<uint32_t, 3> triangle = { remap[result[i]], remap[result[i + 1]], remap[result[i + 2]] };
+
+			auto p0 = positionRemap[triangle[0]], p1 = positionRemap[triangle[1]], p2 = positionRemap[triangle[2]];
+			if (p0 == p1 || p1 == p2 || p0 == p2) continue;
+
+			result[writeIdx++] = triangle[0];
+			result[writeIdx++] = triangle[1];
+			result[writeIdx++] = triangle[2];
+		}
+
+		result.resize(writeIdx);
+	}
+
+	resultError = static_cast<float>(std::sqrt(resultCost));
+
+	return result;
+}
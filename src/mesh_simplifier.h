@@ -0,0 +1,14 @@
+#pragma once
+#include "pch.h"
+
+#include "model_loader.h"
+
+// Edge collapse simplification with quadric error metrics (Garland-Heckbert)
+struct MeshSimplifier
+{
+	// Collapses edges in order of increasing error until the index count drops to targetIndexCount or the next
+	// collapse would exceed maxError. The result indexes into the same vertex array: vertices are only merged into
+	// their neighbours, never moved. UV seam and open border vertices stay in place, so the seams do not tear.
+	// resultError is the largest error of the collapses in model space units.
+	static std::vector<uint32_t> Simplify(std::vector<Vertex> const& vertices, std::vector<uint32_t> const& indices, size_t targetIndexCount, float maxError, float& resultError);
+};
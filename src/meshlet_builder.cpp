@@ -0,0 +1,160 @@
+#include "meshlet_builder.h"
+
+static constexpr uint8_t noLocalIndex = 0xff;
+
+bool Meshlet::IsBackfacing(glm::vec3 const& cameraPos) const
+{
+	// a kup minden normalisa a kamerabol a gomb barmely pontjaba mutato iranytol elfele nez
+	auto toCenter = center - cameraPos;
+	return glm::dot(toCenter, coneAxis) > coneCutoff * glm::length(toCenter) + radius;
+}
+
+void MeshletBuilder::Build(TinyObjShape& shape)
+{
+	shape.meshlets.clear();
+	shape.meshletVertices.clear();
+	shape.meshletTriangles.clear();
+
+	if (shape.indices.size() % 3 != 0) throw std::runtime_error("index count not matching");
+
+	// shape vertex index -> meshlet-en beluli index, csak az aktualis meshlet vertex-eit kell visszaallitani
+	std::vector<uint8_t> localIndices(shape.vertices.size(), noLocalIndex);
+
+	Meshlet current{};
+
+	auto flush = [&]() {
+		if (current.triangleCount == 0) return;
+
+		for (uint32_t i = 0; i < current.vertexCount; i++) {
+			localIndices[shape.meshletVertices[current.vertexOffset + i]] = noLocalIndex;
+		}
+
+		ComputeBounds(current, shape);
+		shape.meshlets.push_back(current);
+
+		current = Meshlet{};
+		current.vertexOffset = static_cast<uint32_t>(shape.meshletVertices.size());
+		current.triangleOffset = static_cast<uint32_t>(shape.meshletTriangles.size());
+	};
+
+	for (size_t i = 0; i < shape.indices.size(); i += 3) {
+		std::array<uint32_t, 3> triangle = { shape.indices[i], shape.indices[i + 1], shape.indices[i + 2] };
+
+		uint32_t newVertexCount = 0;
+		for (auto index : triangle) {
+			if (index >= shape.vertices.size()) throw std::runtime_error("index out of range");
+			if (localIndices[index] == noLocalIndex) newVertexCount++;
+		}
+
+		// ugyanaz a vertex ketszer is szerepelhet egy degeneralt haromszogben, ez csak felulbecsles
+		if (current.vertexCount + newVertexCount > maxVertices || current.triangleCount + 1 > maxTriangles) {
+			flush();
+		}
+
+		for (auto index : triangle) {
+			if (localIndices[index] == noLocalIndex) {
+				localIndices[index] = static_cast<uint8_t>(current.vertexCount++);
+				shape.meshletVertices.push_back(index);
+			}
+
+			shape.meshletTriangles.push_back(localIndices[index]);
+		}
+
+		current.triangleCount++;
+	}
+
+	flush();
+}
+
+void MeshletBuilder::ComputeBounds(Meshlet& meshlet, TinyObjShape const& shape)
+{
+	auto vertexPos = [&](uint32_t localIndex) {
+		return shape.vertices[shape.meshletVertices[meshlet.vertexOffset + localIndex]].pos;
+	};
+
+	// befoglalo gomb: az AABB kozeppontja, a legtavolabbi vertex-ig
+	glm::vec3 boundsMin = vertexPos(0);
+	glm::vec3 boundsMax = vertexPos(0);
+	for (uint32_t i = 1; i < meshlet.vertexCount; i++) {
+		boundsMin = glm::min(boundsMin, vertexPos(i));
+		boundsMax = glm::max(boundsMax, vertexPos(i));
+	}
+
+	meshlet.center = (boundsMin + boundsMax) * 0.5f;
+	meshlet.radius = 0.0f;
+	for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+		meshlet.radius = std::max(meshlet.radius, glm::length(vertexPos(i) - meshlet.center));
+	}
+
+	// normal kup: a haromszog normalisok atlaga a tengely, a legnagyobb elteres a nyilasszog
+	std::vector<glm::vec3> normals;
+	normals.reserve(meshlet.triangleCount);
+
+	glm::vec3 normalSum{ 0.0f, 0.0f, 0.0f };
+	for (uint32_t i = 0; i < meshlet.triangleCount; i++) {
+		auto triangle = shape.meshletTriangles.data() + meshlet.triangleOffset + 3 * i;
+		auto normal = glm::cross(vertexPos(triangle[1]) - vertexPos(triangle[0]), vertexPos(triangle[2]) - vertexPos(triangle[0]));
+
+		auto area = glm::length(normal);
+		if (area <= 0.0f) continue;
+
+		normals.push_back(normal / area);
+		normalSum += normal / area;
+	}
+
+	meshlet.coneAxis = { 0.0f, 0.0f, 1.0f };
+	meshlet.coneCutoff = 1.0f;
+
+	auto axisLength = glm::length(normalSum);
+	if (normals.empty() || axisLength <= 0.0f) return;
+
+	auto axis = normalSum / axisLength;
+	auto minDot = 1.0f;
+	for (auto const& normal : normals) {
+		minDot = std::min(minDot, glm::dot(axis, normal));
+	}
+
+	meshlet.coneAxis = axis;
+
+	// 90 fok feletti felnyilasszognel mindig lathato valamelyik haromszog
+	if (minDot <= 0.0f) return;
+
+	meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+}
+
+void MeshletBuilder::Validate(TinyObjShape const& shape)
+{
+	size_t indexIdx = 0;
+	uint32_t expectedVertexOffset = 0;
+	uint32_t expectedTriangleOffset = 0;
+
+	for (auto const& meshlet : shape.meshlets) {
+		if (meshlet.vertexCount == 0 || meshlet.vertexCount > maxVertices) throw std::runtime_error("meshlet vertex count out of range");
+		if (meshlet.triangleCount == 0 || meshlet.triangleCount > maxTriangles) throw std::runtime_error("meshlet triangle count out of range");
+		if (meshlet.vertexOffset != expectedVertexOffset || meshlet.triangleOffset != expectedTriangleOffset) throw std::runtime_error("meshlets are not contiguous");
+		if (meshlet.vertexOffset + meshlet.vertexCount > shape.meshletVertices.size()) throw std::runtime_error("meshlet vertices out of range");
+		if (meshlet.triangleOffset + 3 * meshlet.triangleCount > shape.meshletTriangles.size()) throw std::runtime_error("meshlet triangles out of range");
+
+		// a lokalis indexekbol visszaallitott index buffer egyezzen az eredetivel
+		for (uint32_t i = 0; i < 3 * meshlet.triangleCount; i++) {
+			auto localIndex = shape.meshletTriangles[meshlet.triangleOffset + i];
+			if (localIndex >= meshlet.vertexCount) throw std::runtime_error("meshlet local index out of range");
+			if (indexIdx >= shape.indices.size() || shape.meshletVertices[meshlet.vertexOffset + localIndex] != shape.indices[indexIdx]) {
+				throw std::runtime_error("meshlets do not match the index buffer");
+			}
+
+			indexIdx++;
+		}
+
+		for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+			auto const& pos = shape.vertices[shape.meshletVertices[meshlet.vertexOffset + i]].pos;
+			auto tolerance = 1e-4f * std::max(1.0f, meshlet.radius);
+			if (glm::length(pos - meshlet.center) > meshlet.radius + tolerance) throw std::runtime_error("meshlet bounding sphere does not contain its vertices");
+		}
+
+		expectedVertexOffset += meshlet.vertexCount;
+		expectedTriangleOffset += 3 * meshlet.triangleCount;
+	}
+
+	if (indexIdx != shape.indices.size()) throw std::runtime_error("meshlets do not cover the index buffer");
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "pch.h"
+
+#include "model_loader.h"
+
+// Splits the index buffer of a shape into small clusters for cluster-level culling
+struct MeshletBuilder
+{
+	static constexpr uint32_t maxVertices = 64;
+	static constexpr uint32_t maxTriangles = 124;
+
+	// Greedy, keeps the triangle order of the index buffer, so the result is deterministic
+	static void Build(TinyObjShape& shape);
+	// Checks that the meshlets cover the index buffer exactly and the bounds contain every vertex, throws on error
+	static void Validate(TinyObjShape const& shape);
+
+private:
+	static void ComputeBounds(Meshlet& meshlet, TinyObjShape const& shape);
+};
@@ -0,0 +1,210 @@
+#include "mip_generator.h"
+
+#if defined(__AVX2__)
+#define MIP_GENERATOR_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIP_GENERATOR_SSE2
+#endif
+
+#if defined(MIP_GENERATOR_SSE2)
+#include <immintrin.h>
+#endif
+
+// 256 sRGB szin, utana 256 alpha ertek, igy egy texel mind a 4 indexe ugyanabba a tablaba mutat
+static auto const decodeTable = [] {
+	std::array<float, 512> table;
+	for (int i = 0; i < 256; i++) {
+		auto value = i / 255.0f;
+		table[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		table[256 + i] = value;
+	}
+
+	return table;
+}();
+
+// a sotet tartomanyban meredek a gorbe, ekkora felbontasnal a hiba joval fel kod alatt marad
+static constexpr int encodeTableSize = 1 << 14;
+
+static auto const encodeTable = [] {
+	std::array<uint8_t, encodeTableSize> table;
+	for (int i = 0; i < encodeTableSize; i++) {
+		auto linear = i / static_cast<float>(encodeTableSize - 1);
+		auto value = linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+		table[i] = static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+	}
+
+	return table;
+}();
+
+uint32_t MipGenerator::GetMipCount(glm::ivec2 size)
+{
+	return static_cast<uint32_t>(std::floor(std::log2(std::max(size.x, size.y)))) + 1;
+}
+
+std::vector<MipLevel> MipGenerator::Generate(glm::ivec2 size, uint8_t const* pixels, PixelFormat format)
+{
+	std::vector<MipLevel> levels;
+	levels.reserve(GetMipCount(size) - 1);
+
+	// minden szint az elozo 8 bites szintbol keszul, igy soronkent csak par float sor kell
+	while (size.x > 1 || size.y > 1) {
+		levels.push_back(Downsample(size, pixels, format));
+		size = levels.back().size;
+		pixels = levels.back().pixels.data();
+	}
+
+	return levels;
+}
+
+MipLevel MipGenerator::Downsample(glm::ivec2 sourceSize, uint8_t const* sourcePixels, PixelFormat format)
+{
+	auto channelCount = static_cast<size_t>(PixelConverter::GetChannelCount(format));
+
+	MipLevel level;
+	level.size = glm::max(sourceSize / 2, glm::ivec2(1));
+	level.pixels.resize(channelCount * level.size.x * level.size.y);
+
+	auto rowTexels = static_cast<size_t>(std::max(sourceSize.x, 2));
+	std::vector<float> row0(4 * rowTexels);
+	std::vector<float> row1(4 * rowTexels);
+	std::vector<float> filtered(size_t{ 4 } * level.size.x);
+
+	auto decodeSourceRow = [&](int y, std::vector<float>& row) {
+		DecodeRow(sourcePixels + channelCount * sourceSize.x * y, format, row.data(), sourceSize.x);
+
+		// az 1 texel szeles forras oszlopa ketszer kerul a szurobe
+		if (sourceSize.x == 1) std::copy_n(row.data(), 4, row.data() + 4);
+	};
+
+	for (int y = 0; y < level.size.y; y++) {
+		decodeSourceRow(2 * y, row0);
+		decodeSourceRow(std::min(2 * y + 1, sourceSize.y - 1), row1);
+
+		FilterRow(row0.data(), row1.data(), filtered.data(), level.size.x);
+		EncodeRow(filtered.data(), format, level.pixels.data() + channelCount * level.size.x * y, level.size.x);
+	}
+
+	return level;
+}
+
+void MipGenerator::DecodeRow(uint8_t const* source, PixelFormat format, float* target, size_t texelCount)
+{
+	size_t texelIdx = 0;
+
+#if defined(MIP_GENERATOR_AVX2)
+	// ket RGBA texel egyszerre: 8 byte-bol 8 tabla index, az alpha a tabla masodik felebe mutat
+	if (format == PixelFormat::RGBA8) {
+		auto alphaOffset = _mm256_setr_epi32(0, 0, 0, 256, 0, 0, 0, 256);
+		for (; texelIdx + 2 <= texelCount; texelIdx += 2) {
+			auto bytes = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(source + 4 * texelIdx));
+			auto indices = _mm256_add_epi32(_mm256_cvtepu8_epi32(bytes), alphaOffset);
+			_mm256_storeu_ps(target + 4 * texelIdx, _mm256_i32gather_ps(decodeTable.data(), indices, sizeof(float)));
+		}
+	}
+#endif
+
+	// a hianyzo csatornak 0-k maradnak, a szures igy mindig 4 csatornas
+	auto channelCount = PixelConverter::GetChannelCount(format);
+	auto alphaChannel = PixelConverter::GetAlphaChannel(format);
+	for (; texelIdx < texelCount; texelIdx++) {
+		auto texel = source + channelCount * texelIdx;
+		auto targetTexel = target + 4 * texelIdx;
+		for (int c = 0; c < 4; c++) {
+			targetTexel[c] = c >= channelCount ? 0.0f : decodeTable[(c == alphaChannel ? 256 : 0) + texel[c]];
+		}
+	}
+}
+
+void MipGenerator::FilterRow(float const* row0, float const* row1, float* target, size_t texelCount)
+{
+	size_t texelIdx = 0;
+
+#if defined(MIP_GENERATOR_AVX2)
+	// ket kimeneti texel egyszerre: eloszor fuggolegesen, majd a 128 bites felek atrendezese utan vizszintesen osszegzunk
+	auto quarter8 = _mm256_set1_ps(0.25f);
+	for (; texelIdx + 2 <= texelCount; texelIdx += 2) {
+		auto sum0 = _mm256_add_ps(_mm256_loadu_ps(row0 + 8 * texelIdx), _mm256_loadu_ps(row1 + 8 * texelIdx));
+		auto sum1 = _mm256_add_ps(_mm256_loadu_ps(row0 + 8 * texelIdx + 8), _mm256_loadu_ps(row1 + 8 * texelIdx + 8));
+
+		auto left = _mm256_permute2f128_ps(sum0, sum1, 0x20);
+		auto right = _mm256_permute2f128_ps(sum0, sum1, 0x31);
+		_mm256_storeu_ps(target + 4 * texelIdx, _mm256_mul_ps(_mm256_add_ps(left, right), quarter8));
+	}
+#endif
+
+#if defined(MIP_GENERATOR_SSE2)
+	// egy texel 4 csatornaja egy regiszter, ugyanabban a sorrendben osszegzunk mint az AVX2 ag
+	auto quarter = _mm_set1_ps(0.25f);
+	for (; texelIdx < texelCount; texelIdx++) {
+		auto sum0 = _mm_add_ps(_mm_loadu_ps(row0 + 8 * texelIdx), _mm_loadu_ps(row1 + 8 * texelIdx));
+		auto sum1 = _mm_add_ps(_mm_loadu_ps(row0 + 8 * texelIdx + 4), _mm_loadu_ps(row1 + 8 * texelIdx + 4));
+		_mm_storeu_ps(target + 4 * texelIdx, _mm_mul_ps(_mm_add_ps(sum0, sum1), quarter));
+	}
+#else
+	for (; texelIdx < texelCount; texelIdx++) {
+		for (int c = 0; c < 4; c++) {
+			auto sum0 = row0[8 * texelIdx + c] + row1[8 * texelIdx + c];
+			auto sum1 = row0[8 * texelIdx + 4 + c] + row1[8 * texelIdx + 4 + c];
+			target[4 * texelIdx + c] = (sum0 + sum1) * 0.25f;
+		}
+	}
+#endif
+}
+
+void MipGenerator::EncodeRow(float const* source, PixelFormat format, uint8_t* target, size_t texelCount)
+{
+	auto channelCount = PixelConverter::GetChannelCount(format);
+	auto alphaChannel = PixelConverter::GetAlphaChannel(format);
+
+	// a szin csatornakbol tabla index lesz, az alpha kerekitve mar maga a kimeneti ertek
+	auto storeTexel = [&](int32_t const* indices, uint8_t* texel) {
+		for (int c = 0; c < channelCount; c++) {
+			texel[c] = c == alphaChannel ? static_cast<uint8_t>(indices[c]) : encodeTable[indices[c]];
+		}
+	};
+
+	size_t texelIdx = 0;
+
+#if defined(MIP_GENERATOR_SSE2)
+	constexpr auto colorScale = static_cast<float>(encodeTableSize - 1);
+	std::array<float, 4> scales = { colorScale, colorScale, colorScale, colorScale };
+	if (alphaChannel >= 0) scales[alphaChannel] = 255.0f;
+
+	alignas(32) std::array<int32_t, 8> indices;
+
+#if defined(MIP_GENERATOR_AVX2)
+	auto scale8 = _mm256_setr_ps(scales[0], scales[1], scales[2], scales[3], scales[0], scales[1], scales[2], scales[3]);
+	auto zero8 = _mm256_setzero_ps();
+	auto one8 = _mm256_set1_ps(1.0f);
+	for (; texelIdx + 2 <= texelCount; texelIdx += 2) {
+		auto value = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(source + 4 * texelIdx), zero8), one8);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(indices.data()), _mm256_cvtps_epi32(_mm256_mul_ps(value, scale8)));
+
+		storeTexel(indices.data(), target + channelCount * texelIdx);
+		storeTexel(indices.data() + 4, target + channelCount * (texelIdx + 1));
+	}
+#endif
+
+	auto scale = _mm_loadu_ps(scales.data());
+	auto zero = _mm_setzero_ps();
+	auto one = _mm_set1_ps(1.0f);
+	for (; texelIdx < texelCount; texelIdx++) {
+		auto value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(source + 4 * texelIdx), zero), one);
+		_mm_store_si128(reinterpret_cast<__m128i*>(indices.data()), _mm_cvtps_epi32(_mm_mul_ps(value, scale)));
+
+		storeTexel(indices.data(), target + channelCount * texelIdx);
+	}
+#else
+	for (; texelIdx < texelCount; texelIdx++) {
+		std::array<int32_t, 4> indices;
+		for (int c = 0; c < 4; c++) {
+			auto scale = c == alphaChannel ? 255.0f : static_cast<float>(encodeTableSize - 1);
+			indices[c] = static_cast<int32_t>(std::lrint(std::clamp(source[4 * texelIdx + c], 0.0f, 1.0f) * scale));
+		}
+
+		storeTexel(indices.data(), target + channelCount * texelIdx);
+	}
+#endif
+}
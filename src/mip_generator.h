@@ -0,0 +1,23 @@
+#pragma once
+#include "pch.h"
+
+#include "image_cache.h"
+
+// sRGB-correct mip chain on the CPU: the texels are averaged in linear space, alpha is kept linear.
+// Works on every PixelFormat, the levels keep the format of the base level.
+struct MipGenerator
+{
+	// Every level down to 1x1
+	static uint32_t GetMipCount(glm::ivec2 size);
+	// The levels below the given base level, from size / 2 down to 1x1
+	static std::vector<MipLevel> Generate(glm::ivec2 size, uint8_t const* pixels, PixelFormat format);
+	// 2x2 box filter, odd sizes drop the last row / column, a 1 texel wide edge is repeated
+	static MipLevel Downsample(glm::ivec2 sourceSize, uint8_t const* sourcePixels, PixelFormat format);
+
+private:
+	// sRGB -> linear for the color channels, then unorm -> float for alpha, always 4 floats per texel
+	static void DecodeRow(uint8_t const* source, PixelFormat format, float* target, size_t texelCount);
+	// Averages 2x2 texel quads of two linear rows into texelCount target texels
+	static void FilterRow(float const* row0, float const* row1, float* target, size_t texelCount);
+	static void EncodeRow(float const* source, PixelFormat format, uint8_t* target, size_t texelCount);
+};
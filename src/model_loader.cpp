@@ -1,6 +1,25 @@
 #include "model_loader.h"
 
 #include "runcfg.h"
+#include "utils.h"
+#include "mesh_cache.h"
+#include "thread_pool.h"
+#include "vertex_dedup_table.h"
+#include "mesh_optimizer.h"
+#include "vertex_packer.h"
+#include "meshlet_builder.h"
+#include "mesh_simplifier.h"
+#include "load_report.h"
+#include "texture_cache.h"
+
+// A tinyobj stream-es LoadObj-jat mar beolvasott memoriabol etetjuk
+struct MemoryStreamBuffer : std::streambuf
+{
+	MemoryStreamBuffer(char* begin, size_t size)
+	{
+		setg(begin, begin, begin + size);
+	}
+};
 
 bool Vertex::operator==(const Vertex& other) const
 {
@@ -27,10 +46,68 @@ LoadedModel ModelLoader::Load(std::string const& fileName, std::string const& mt
 
 	theLogger.LogInfo("Loading {}", fileName);
 
+	assetName = fileName;
+	LoadReport::ScopedPhase totalPhase(assetName, "total");
+
 	auto timerStart = std::chrono::high_resolution_clock::now();
 
-	if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, fileName.c_str(), mtlDirectory.c_str())) {
-		throw std::runtime_error(warn + err);
+	std::vector<char> objData;
+	{
+		LoadReport::ScopedPhase phase(assetName, "fileRead");
+		objData = Utils::ReadBinaryFile(fileName);
+	}
+	theLoadReport.AddCounter(assetName, "fileBytes", objData.size());
+
+	uint64_t sourceHash;
+	{
+		LoadReport::ScopedPhase phase(assetName, "hashSources");
+		sourceHash = HashSources(objData, mtlDirectory);
+	}
+	auto cachePath = MeshCache::GetCachePath(fileName);
+
+	if (loadsettings.useMeshCache) {
+		std::optional<LoadedModel> cachedModel;
+		{
+			LoadReport::ScopedPhase phase(assetName, "meshCacheLoad");
+			cachedModel = MeshCache::TryLoad(cachePath, sourceHash, loadsettings.Hash());
+		}
+
+		if (cachedModel) {
+			cachedModel->name = fileName;
+			theLoadReport.AddCounter(assetName, "meshCacheHit", 1);
+
+			// ha azota eltunt egy textura, akkor a default-ra essen vissza
+			for (auto& material : cachedModel->materials) {
+				material.diffuseTexture = HandleDefaultTexure(material.diffuseTexture);
+			}
+
+			auto timerStop = std::chrono::high_resolution_clock::now();
+			auto loadTime = std::chrono::duration_cast<std::chrono::milliseconds>(timerStop - timerStart).count();
+			theLogger.LogInfo("Loading {} from mesh cache finished in {} ms", fileName, loadTime);
+
+			if (loadsettings.benchmarkDedup) {
+				BenchmarkDedup(*cachedModel);
+			}
+
+			LoadMaterialTextures(cachedModel->materials);
+			ReportModelStats(*cachedModel);
+
+			return std::move(*cachedModel);
+		}
+	}
+
+	theLoadReport.AddCounter(assetName, "meshCacheHit", 0);
+
+	// a tinyobj MaterialFileReader nem tesz elvalasztot a konyvtar utan
+	tinyobj::MaterialFileReader materialFileReader((fs::path(mtlDirectory) / "").string());
+	MemoryStreamBuffer objStreamBuffer(objData.data(), objData.size());
+	std::istream objStream(&objStreamBuffer);
+
+	{
+		LoadReport::ScopedPhase phase(assetName, "parse");
+		if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, &objStream, &materialFileReader)) {
+			throw std::runtime_error(warn + err);
+		}
 	}
 
 	auto timerStop = std::chrono::high_resolution_clock::now();
@@ -46,27 +123,267 @@ LoadedModel ModelLoader::Load(std::string const& fileName, std::string const& mt
 		throw std::runtime_error(err);
 	}
 
-	CheckMaterialIds(shapes);
-
 	LoadedModel loadedModel;
+	loadedModel.name = fileName;
+
+	{
+		LoadReport::ScopedPhase phase(assetName, "materials");
+
+		CheckMaterialIds(shapes, materials.size());
+
+		// minden shape-nek egy anyaga legyen, merge eseten anyagonkent egy shape
+		auto shapeCount = shapes.size();
+		shapes = SplitShapesByMaterial(shapes, loadsettings.mergeByMaterial);
+		if (shapes.size() != shapeCount) {
+			theLogger.LogInfo("Shapes regrouped by material: {} -> {}", shapeCount, shapes.size());
+		}
+
+		for (auto const& material : materials)
+		{
+			fs::path mtlDirectoryPath = mtlDirectory;
+			auto fullDiffuse = HandleDefaultTexure(mtlDirectoryPath / material.diffuse_texname);
+
+			TinyObjMaterial newMaterial(fullDiffuse);
+			loadedModel.materials.push_back(std::move(newMaterial));
+		}
+	}
 
-	for (auto const& material : materials)
 	{
-		fs::path mtlDirectoryPath = mtlDirectory;
-		auto fullDiffuse = HandleDefaultTexure(mtlDirectoryPath / material.diffuse_texname);
+		LoadReport::ScopedPhase phase(assetName, "buildShapes");
+		BuildShapes(loadedModel, attrib, shapes, loadsettings);
+	}
+
+	if (loadsettings.benchmarkDedup) {
+		BenchmarkDedup(loadedModel);
+	}
+
+	if (loadsettings.useMeshCache) {
+		LoadReport::ScopedPhase phase(assetName, "meshCacheStore");
+		MeshCache::Store(cachePath, loadedModel, sourceHash, loadsettings.Hash());
+	}
+
+	LoadMaterialTextures(loadedModel.materials);
+	ReportModelStats(loadedModel);
+
+	return loadedModel;
+}
+
+std::future<LoadedModel> ModelLoader::LoadAsync(std::string const& fileName, std::string const& mtlDirectory, LoadSettings const& loadsettings)
+{
+	// a parameterek masolatat visszuk at, a hivo oldalon lehet hogy mar nem elnek
+	return theThreadPool.Submit([fileName, mtlDirectory, loadsettings]() {
+		ModelLoader modelLoader;
+		return modelLoader.Load(fileName, mtlDirectory, loadsettings);
+	});
+}
 
-		TinyObjMaterial newMaterial(fullDiffuse);
-		loadedModel.materials.push_back(std::move(newMaterial));
+void ModelLoader::BuildShapes(LoadedModel& loadedModel, tinyobj::attrib_t const& attrib, std::vector<tinyobj::shape_t> const& shapes, LoadSettings const& loadsettings)
+{
+	auto timerStart = std::chrono::high_resolution_clock::now();
+
+	loadedModel.shapes.resize(shapes.size());
+	std::vector<double> shapeTimes(shapes.size());
+
+	bool isOptimizing = loadsettings.optimizeVertexCache || loadsettings.optimizeOverdraw || loadsettings.optimizeVertexFetch;
+	std::vector<MeshOptimizer::CacheStats> statsBefore(shapes.size()), statsAfter(shapes.size());
+
+	// a shape-ek egymastol fuggetlenek, igy mindegyik a sajat helyere irhat
+	auto buildShape = [&](size_t shapeIdx) {
+		auto shapeTimerStart = std::chrono::high_resolution_clock::now();
+
+		auto& newShape = loadedModel.shapes[shapeIdx];
+		newShape = BuildShape(attrib, shapes[shapeIdx], loadsettings);
+
+		if (isOptimizing) {
+			LoadReport::ScopedPhase phase(assetName, "buildShapes.optimize");
+			statsBefore[shapeIdx] = MeshOptimizer::AnalyzeVertexCache(newShape.indices, newShape.vertices.size());
+			OptimizeShape(newShape, loadsettings);
+			statsAfter[shapeIdx] = MeshOptimizer::AnalyzeVertexCache(newShape.indices, newShape.vertices.size());
+		}
+
+		// a vertex fetch optimalizacio utan mar a vegleges vertex szam ismert
+		newShape.indexType = VertexPacker::SelectIndexType(newShape.vertices.size());
+
+		// a meshlet-ek a vegleges index sorrendbol keszulnek
+		if (loadsettings.buildMeshlets) {
+			LoadReport::ScopedPhase phase(assetName, "buildShapes.meshlets");
+			BuildMeshlets(newShape);
+		}
+
+		if (loadsettings.lodCount > 0) {
+			LoadReport::ScopedPhase phase(assetName, "buildShapes.lods");
+			BuildLods(newShape, loadsettings);
+		}
+
+		auto shapeTimerStop = std::chrono::high_resolution_clock::now();
+		shapeTimes[shapeIdx] = std::chrono::duration<double, std::milli>(shapeTimerStop - shapeTimerStart).count();
+	};
+
+	size_t threadCount = 1;
+	if (loadsettings.parallelShapes && shapes.size() > 1) {
+		threadCount = std::min(shapes.size(), theThreadPool.GetWorkerCount() + 1);
+		theThreadPool.ParallelFor(shapes.size(), buildShape);
+	}
+	else {
+		for (size_t shapeIdx = 0; shapeIdx < shapes.size(); shapeIdx++) {
+			buildShape(shapeIdx);
+		}
+	}
+
+	auto timerStop = std::chrono::high_resolution_clock::now();
+	auto wallTime = std::chrono::duration<double, std::milli>(timerStop - timerStart).count();
+
+	double serialTime = 0.0;
+	for (size_t shapeIdx = 0; shapeIdx < shapes.size(); shapeIdx++) {
+		auto const& shape = loadedModel.shapes[shapeIdx];
+		theLogger.LogInfo("Shape #{} ({}): {} vertices, {} indices ({}) in {:.2f} ms", shapeIdx, shapes[shapeIdx].name, shape.vertices.size(), shape.indices.size(),
+			shape.indexType == IndexType::UINT16 ? "uint16" : "uint32", shapeTimes[shapeIdx]);
+		serialTime += shapeTimes[shapeIdx];
+	}
+
+	auto speedup = wallTime > 0.0 ? serialTime / wallTime : 1.0;
+	theLogger.LogInfo("Building {} shapes finished in {:.2f} ms on {} threads (sum of shape times {:.2f} ms, speedup {:.2f}x)", shapes.size(), wallTime, threadCount, serialTime, speedup);
+
+	if (isOptimizing) {
+		MeshOptimizer::CacheStats totalBefore, totalAfter;
+		for (size_t shapeIdx = 0; shapeIdx < shapes.size(); shapeIdx++) {
+			totalBefore += statsBefore[shapeIdx];
+			totalAfter += statsAfter[shapeIdx];
+		}
+
+		theLogger.LogInfo("Mesh optimization (FIFO cache of {}): ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, transformed vertices {} -> {}",
+			MeshOptimizer::analyzeCacheSize, totalBefore.Acmr(), totalAfter.Acmr(), totalBefore.Atvr(), totalAfter.Atvr(), totalBefore.misses, totalAfter.misses);
 	}
 
+	if (loadsettings.buildMeshlets) {
+		size_t meshletCount = 0, meshletVertexCount = 0, triangleCount = 0;
+		for (auto const& shape : loadedModel.shapes) {
+			meshletCount += shape.meshlets.size();
+			meshletVertexCount += shape.meshletVertices.size();
+			triangleCount += shape.indices.size() / 3;
+		}
+
+		auto averageTriangles = meshletCount > 0 ? static_cast<double>(triangleCount) / meshletCount : 0.0;
+		auto averageVertices = meshletCount > 0 ? static_cast<double>(meshletVertexCount) / meshletCount : 0.0;
+		theLogger.LogInfo("Built {} meshlets (max {} vertices / {} triangles), on average {:.1f} vertices and {:.1f} triangles per meshlet",
+			meshletCount, MeshletBuilder::maxVertices, MeshletBuilder::maxTriangles, averageVertices, averageTriangles);
+	}
+
+	if (loadsettings.lodCount > 0) {
+		size_t fullTriangleCount = 0;
+		for (auto const& shape : loadedModel.shapes) {
+			fullTriangleCount += shape.indices.size() / 3;
+		}
+
+		// a szinteket nem minden shape-nel sikerul felepiteni, ilyenkor a legdurvabb meglevo szintet szamoljuk
+		for (uint32_t lodIdx = 1; lodIdx <= loadsettings.lodCount; lodIdx++) {
+			size_t triangleCount = 0;
+			float maxError = 0.0f;
+			for (auto const& shape : loadedModel.shapes) {
+				if (shape.lods.empty()) {
+					triangleCount += shape.indices.size() / 3;
+					continue;
+				}
+
+				auto const& lod = shape.lods[std::min<size_t>(lodIdx, shape.lods.size()) - 1];
+				triangleCount += lod.indexCount / 3;
+				maxError = std::max(maxError, lod.error);
+			}
+
+			auto ratio = fullTriangleCount > 0 ? 100.0 * triangleCount / fullTriangleCount : 0.0;
+			theLogger.LogInfo("LOD {}: {} triangles ({:.1f}% of {}), max error {:.5f}", lodIdx, triangleCount, ratio, fullTriangleCount, maxError);
+		}
+	}
+}
+
+void ModelLoader::OptimizeShape(TinyObjShape& shape, LoadSettings const& loadsettings)
+{
+	if (loadsettings.optimizeVertexCache) {
+		MeshOptimizer::OptimizeVertexCache(shape.indices, shape.vertices.size());
+	}
+
+	// az overdraw a vertex cache sorrendben levo klasztereket rendezi at, ezert utana kell jonnie
+	if (loadsettings.optimizeOverdraw) {
+		MeshOptimizer::OptimizeOverdraw(shape.indices, shape.vertices);
+	}
+
+	// a vegleges index sorrendhez igazitjuk a vertex-eket
+	if (loadsettings.optimizeVertexFetch) {
+		MeshOptimizer::OptimizeVertexFetch(shape.vertices, shape.indices);
+	}
+}
+
+void ModelLoader::BuildMeshlets(TinyObjShape& shape)
+{
+	MeshletBuilder::Build(shape);
+
+#ifndef NDEBUG
+	MeshletBuilder::Validate(shape);
+#endif
+}
+
+void ModelLoader::BuildLods(TinyObjShape& shape, LoadSettings const& loadsettings)
+{
+	// minden szint az elozo haromszogszamanak a fele, a hiba a shape meretehez kepest korlatos
+	static constexpr float lodTriangleRatio = 0.5f;
+	static constexpr float lodMaxRelativeError = 0.05f;
+	static constexpr float lodMinReduction = 0.9f;
+
+	if (shape.vertices.empty()) return;
+
+	glm::vec3 boundsMin = shape.vertices[0].pos;
+	glm::vec3 boundsMax = shape.vertices[0].pos;
+	for (auto const& vertex : shape.vertices) {
+		boundsMin = glm::min(boundsMin, vertex.pos);
+		boundsMax = glm::max(boundsMax, vertex.pos);
+	}
+
+	auto maxError = lodMaxRelativeError * glm::length(boundsMax - boundsMin);
+
+	auto sourceIndices = shape.indices;
+	float sourceError = 0.0f;
+
+	for (uint32_t lodIdx = 1; lodIdx <= loadsettings.lodCount; lodIdx++) {
+		auto targetIndexCount = static_cast<size_t>(sourceIndices.size() / 3 * lodTriangleRatio) * 3;
+
+		float lodError = 0.0f;
+		auto lodIndices = MeshSimplifier::Simplify(shape.vertices, sourceIndices, targetIndexCount, maxError - sourceError, lodError);
+
+		// ha mar alig csokken a haromszogszam, a tovabbi szintek feleslegesek
+		if (lodIndices.empty() || lodIndices.size() > sourceIndices.size() * lodMinReduction) break;
+
+		if (loadsettings.optimizeVertexCache) {
+			MeshOptimizer::OptimizeVertexCache(lodIndices, shape.vertices.size());
+		}
+
+		// a szinteket az elozobol egyszerusitjuk, igy a hibak osszeadodnak
+		sourceError += lodError;
+
+		ShapeLod lod;
+		lod.indexOffset = static_cast<uint32_t>(shape.lodIndices.size());
+		lod.indexCount = static_cast<uint32_t>(lodIndices.size());
+		lod.error = sourceError;
+		shape.lods.push_back(lod);
+
+		shape.lodIndices.insert(shape.lodIndices.end(), lodIndices.begin(), lodIndices.end());
+		sourceIndices = std::move(lodIndices);
+	}
+}
+
+TinyObjShape ModelLoader::BuildShape(tinyobj::attrib_t const& attrib, tinyobj::shape_t const& shape, LoadSettings const& loadsettings)
+{
 	bool isMissingUVs = attrib.texcoords.size() == 0;
 
-	for (auto const& shape : shapes)
+	TinyObjShape newShape;
+	newShape.materialId = shape.mesh.material_ids[0];
+
 	{
-		TinyObjShape newShape;
-		newShape.materialId = shape.mesh.material_ids[0];
+		LoadReport::ScopedPhase phase(assetName, "buildShapes.dedup");
+
+		// egyedi vertex-ek szama nagyjabol az indexek harmada, a tabla szukseg eseten no
+		VertexDedupTable uniqueVertices(shape.mesh.indices.size() / 3);
+		newShape.indices.reserve(shape.mesh.indices.size());
 
-		std::unordered_map<Vertex, uint32_t, Vertex::Hasher> uniqueVertices;
 		for (auto const& index : shape.mesh.indices) {
 			Vertex vertex{};
 
@@ -85,53 +402,251 @@ LoadedModel ModelLoader::Load(std::string const& fileName, std::string const& mt
 
 			vertex.color = { 1.0f, 1.0f, 1.0f };
 
+			newShape.indices.push_back(uniqueVertices.InsertOrGet(vertex, newShape.vertices));
+		}
+	}
+
+	if (loadsettings.flipWinding) {
+		LoadReport::ScopedPhase phase(assetName, "buildShapes.windingFlip");
+
+		if (newShape.indices.size() % 3 != 0) throw std::runtime_error("index count not matching");
+
+		for (int i = 0; i < newShape.indices.size(); i += 3) {
+			std::swap(newShape.indices[i], newShape.indices[i + 2]);
+		}
+	}
+
+	return newShape;
+}
+
+void ModelLoader::BenchmarkDedup(LoadedModel const& loadedModel)
+{
+	// a kesz shape-ekbol visszaallitjuk a deduplikalas elotti vertex folyamot
+	std::vector<std::vector<Vertex>> vertexStreams;
+	size_t totalIndexCount = 0;
+
+	for (auto const& shape : loadedModel.shapes) {
+		auto& vertexStream = vertexStreams.emplace_back();
+		vertexStream.reserve(shape.indices.size());
+		for (auto index : shape.indices) {
+			vertexStream.push_back(shape.vertices[index]);
+		}
+
+		totalIndexCount += shape.indices.size();
+	}
+
+	auto dedupWithUnorderedMap = [](std::vector<Vertex> const& vertexStream, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+		std::unordered_map<Vertex, uint32_t, Vertex::Hasher> uniqueVertices;
+		for (auto const& vertex : vertexStream) {
 			if (uniqueVertices.find(vertex) == uniqueVertices.end()) {
-				uniqueVertices[vertex] = static_cast<uint32_t>(newShape.vertices.size());
-				newShape.vertices.push_back(vertex);
+				uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
+				vertices.push_back(vertex);
 			}
 
-			newShape.indices.push_back(uniqueVertices[vertex]);
+			indices.push_back(uniqueVertices[vertex]);
+		}
+	};
+
+	auto dedupWithFlatTable = [](std::vector<Vertex> const& vertexStream, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+		VertexDedupTable uniqueVertices(vertexStream.size() / 3);
+		for (auto const& vertex : vertexStream) {
+			indices.push_back(uniqueVertices.InsertOrGet(vertex, vertices));
 		}
+	};
+
+	// a legjobb futasi idot vesszuk, az eredmenyeket az utolso korbol hasonlitjuk ossze
+	auto measure = [&vertexStreams](auto const& dedup, std::vector<std::vector<uint32_t>>& resultIndices) {
+		constexpr int iterationCount = 5;
+		double bestTime = std::numeric_limits<double>::max();
+
+		for (int iteration = 0; iteration < iterationCount; iteration++) {
+			resultIndices.assign(vertexStreams.size(), {});
 
-		if (loadsettings.flipWinding) {
-			if (newShape.indices.size() % 3 != 0) throw std::runtime_error("index count not matching");
+			auto timerStart = std::chrono::high_resolution_clock::now();
 
-			for (int i = 0; i < newShape.indices.size(); i += 3) {
-				std::swap(newShape.indices[i], newShape.indices[i + 2]);
+			for (size_t streamIdx = 0; streamIdx < vertexStreams.size(); streamIdx++) {
+				std::vector<Vertex> vertices;
+				resultIndices[streamIdx].reserve(vertexStreams[streamIdx].size());
+				dedup(vertexStreams[streamIdx], vertices, resultIndices[streamIdx]);
 			}
+
+			auto timerStop = std::chrono::high_resolution_clock::now();
+			bestTime = std::min(bestTime, std::chrono::duration<double, std::milli>(timerStop - timerStart).count());
 		}
 
-		loadedModel.shapes.push_back(std::move(newShape));
+		return bestTime;
+	};
+
+	std::vector<std::vector<uint32_t>> unorderedMapIndices, flatTableIndices;
+	auto unorderedMapTime = measure(dedupWithUnorderedMap, unorderedMapIndices);
+	auto flatTableTime = measure(dedupWithFlatTable, flatTableIndices);
+
+	if (unorderedMapIndices != flatTableIndices) {
+		theLogger.LogError("Dedup benchmark: flat table result differs from unordered_map result");
 	}
 
-	LoadMaterialTextures(loadedModel.materials);
+	auto speedup = flatTableTime > 0.0 ? unorderedMapTime / flatTableTime : 1.0;
+	theLogger.LogInfo("Dedup benchmark: {} indices, unordered_map {:.2f} ms, flat table {:.2f} ms, speedup {:.2f}x", totalIndexCount, unorderedMapTime, flatTableTime, speedup);
+}
 
-	return loadedModel;
+uint64_t ModelLoader::HashSources(std::vector<char> const& objData, std::string const& mtlDirectory)
+{
+	auto hash = Utils::HashBytes(objData.data(), objData.size());
+
+	// az mtl fajlok is befolyasoljak az eredmenyt, rendezve hogy a sorrend determinisztikus legyen
+	std::vector<fs::path> mtlPaths;
+	for (auto const& entry : fs::directory_iterator(mtlDirectory)) {
+		if (entry.is_regular_file() && entry.path().extension() == ".mtl") {
+			mtlPaths.push_back(entry.path());
+		}
+	}
+
+	std::sort(mtlPaths.begin(), mtlPaths.end());
+
+	for (auto const& mtlPath : mtlPaths) {
+		auto mtlData = Utils::ReadBinaryFile(mtlPath.string());
+		hash = Utils::HashBytes(mtlData.data(), mtlData.size(), hash);
+	}
+
+	return hash;
 }
 
-void ModelLoader::CheckMaterialIds(std::vector<tinyobj::shape_t> const& shapes)
+void ModelLoader::CheckMaterialIds(std::vector<tinyobj::shape_t> const& shapes, size_t materialCount)
 {
+	// a vegyes anyagu shape-eket a SplitShapesByMaterial szetvagja
 	for (auto const& shape : shapes)
 	{
-		auto firstMaterialId = shape.mesh.material_ids[0];
-		if (firstMaterialId == -1) {
-			throw std::runtime_error("no material");
+		for (auto materialId : shape.mesh.material_ids) {
+			if (materialId == -1) {
+				throw std::runtime_error("no material");
+			}
+
+			if (static_cast<size_t>(materialId) >= materialCount) {
+				throw std::runtime_error("invalid materialId");
+			}
 		}
+	}
+}
+
+std::vector<tinyobj::shape_t> ModelLoader::SplitShapesByMaterial(std::vector<tinyobj::shape_t> const& shapes, bool mergeShapes)
+{
+	std::vector<tinyobj::shape_t> newShapes;
 
-		for (int materialIdIdx = 1; materialIdIdx < shape.mesh.material_ids.size(); materialIdIdx++) {
-			auto materialId = shape.mesh.material_ids[materialIdIdx];
-			if (materialId != firstMaterialId) {
-				throw std::runtime_error("materialIds are mixed up");
+	// (shape, anyag) -> uj shape; merge eseten a shape index mindig 0, igy anyagonkent egy lesz
+	std::map<std::pair<size_t, int>, size_t> newShapeIndices;
+
+	for (size_t shapeIdx = 0; shapeIdx < shapes.size(); shapeIdx++) {
+		auto const& mesh = shapes[shapeIdx].mesh;
+
+		size_t indexOffset = 0;
+		for (size_t faceIdx = 0; faceIdx < mesh.num_face_vertices.size(); faceIdx++) {
+			auto faceVertexCount = mesh.num_face_vertices[faceIdx];
+			auto materialId = mesh.material_ids[faceIdx];
+
+			auto key = std::make_pair(mergeShapes ? size_t{ 0 } : shapeIdx, materialId);
+			auto [it, inserted] = newShapeIndices.try_emplace(key, newShapes.size());
+			if (inserted) {
+				auto& newShape = newShapes.emplace_back();
+				newShape.name = mergeShapes ? fmt::format("material #{}", materialId) : shapes[shapeIdx].name;
 			}
+
+			auto& newMesh = newShapes[it->second].mesh;
+			newMesh.indices.insert(newMesh.indices.end(), mesh.indices.begin() + indexOffset, mesh.indices.begin() + indexOffset + faceVertexCount);
+			newMesh.num_face_vertices.push_back(faceVertexCount);
+			newMesh.material_ids.push_back(materialId);
+
+			indexOffset += faceVertexCount;
+		}
+	}
+
+	return newShapes;
+}
+
+void ModelLoader::LoadMaterialTextures(std::vector<TinyObjMaterial>& materials)
+{
+	if (auto textureFormat = TextureCompressor::ParseFormat(theRuncfg.textureFormat)) {
+		LoadCompressedMaterialTextures(materials, *textureFormat);
+		return;
+	}
+
+	LoadReport::ScopedPhase phase(assetName, "textureDecode");
+
+	std::vector<std::string> paths;
+	for (auto const& material : materials) {
+		paths.push_back(material.diffuseTexture);
+	}
+
+	auto diffuseImages = theImageCache.LoadMany(paths);
+
+	// tobb anyag is hivatkozhat ugyanarra a texturara, azokat csak egyszer szamoljuk
+	std::vector<Image const*> images;
+	for (size_t materialIdx = 0; materialIdx < materials.size(); materialIdx++) {
+		auto& material = materials[materialIdx];
+		material.diffuseImage = std::move(diffuseImages[materialIdx]);
+		if (std::find(images.begin(), images.end(), material.diffuseImage.get()) == images.end()) {
+			images.push_back(material.diffuseImage.get());
 		}
 	}
+
+	uint64_t textureBytes = 0;
+	for (auto image : images) {
+		textureBytes += image->GetChainSizeBytes();
+	}
+
+	theLoadReport.AddCounter(assetName, "textureCount", images.size());
+	theLoadReport.AddCounter(assetName, "textureBytes", textureBytes);
 }
 
-void ModelLoader::LoadMaterialTextures(std::vector<TinyObjMaterial> const& materials)
+void ModelLoader::LoadCompressedMaterialTextures(std::vector<TinyObjMaterial>& materials, BlockFormat format)
 {
+	LoadReport::ScopedPhase phase(assetName, "textureCompress");
+
+	// tobb anyag is hivatkozhat ugyanarra a texturara, azokat csak egyszer toltjuk be
+	std::vector<std::string> uniquePaths;
+	std::vector<size_t> pathIndices;
 	for (auto const& material : materials) {
-		theImageCache.Load(material.diffuseTexture);
+		auto key = ImageCache::NormalizePath(material.diffuseTexture);
+		auto it = std::find(uniquePaths.begin(), uniquePaths.end(), key);
+		pathIndices.push_back(it - uniquePaths.begin());
+		if (it == uniquePaths.end()) uniquePaths.push_back(key);
+	}
+
+	// a cache talalat csak egy fajl olvasas, a tomorites maga is a pool-on fut
+	std::vector<std::shared_ptr<CompressedTexture const>> textures(uniquePaths.size());
+	theThreadPool.ParallelFor(uniquePaths.size(), [&](size_t pathIdx) {
+		textures[pathIdx] = TextureCache::LoadOrCompress(uniquePaths[pathIdx], format);
+	});
+
+	for (size_t materialIdx = 0; materialIdx < materials.size(); materialIdx++) {
+		materials[materialIdx].diffuseCompressed = textures[pathIndices[materialIdx]];
+	}
+
+	uint64_t textureBytes = 0;
+	for (auto const& texture : textures) {
+		textureBytes += texture->GetSizeBytes();
+	}
+
+	theLoadReport.AddCounter(assetName, "textureCount", textures.size());
+	theLoadReport.AddCounter(assetName, "textureBytes", textureBytes);
+}
+
+void ModelLoader::ReportModelStats(LoadedModel const& loadedModel)
+{
+	uint64_t vertexCount = 0, indexCount = 0, lodIndexCount = 0, meshletCount = 0;
+	for (auto const& shape : loadedModel.shapes) {
+		vertexCount += shape.vertices.size();
+		indexCount += shape.indices.size();
+		lodIndexCount += shape.lodIndices.size();
+		meshletCount += shape.meshlets.size();
 	}
+
+	theLoadReport.AddCounter(assetName, "shapeCount", loadedModel.shapes.size());
+	theLoadReport.AddCounter(assetName, "materialCount", loadedModel.materials.size());
+	theLoadReport.AddCounter(assetName, "vertexCount", vertexCount);
+	theLoadReport.AddCounter(assetName, "indexCount", indexCount);
+	theLoadReport.AddCounter(assetName, "lodIndexCount", lodIndexCount);
+	theLoadReport.AddCounter(assetName, "meshletCount", meshletCount);
+	theLoadReport.AddCounter(assetName, "vertexBytes", vertexCount * sizeof(Vertex));
 }
 
 std::string ModelLoader::HandleDefaultTexure(fs::path const& path)
@@ -143,6 +658,22 @@ std::string ModelLoader::HandleDefaultTexure(fs::path const& path)
 	return (theRuncfg.texturesDir / "helper" / "default_diffuse.tga").string();
 }
 
+uint64_t ModelLoader::LoadSettings::Hash() const
+{
+	std::array<uint8_t, 8> fields = {
+		flipWinding,
+		ignoreMissingUVs,
+		optimizeVertexCache,
+		optimizeOverdraw,
+		optimizeVertexFetch,
+		buildMeshlets,
+		static_cast<uint8_t>(lodCount),
+		mergeByMaterial
+	};
+
+	return Utils::HashBytes(fields.data(), fields.size());
+}
+
 TinyObjMaterial::TinyObjMaterial(std::string const& diffuseTexture)
 	: diffuseTexture{ diffuseTexture }
 {
@@ -2,6 +2,7 @@
 #include "pch.h"
 
 #include "image_cache.h"
+#include "texture_compressor.h"
 #include "runcfg.h"
 
 struct Vertex
@@ -18,22 +19,71 @@ struct Vertex
 	};
 };
 
+// The index type of the GPU index buffer, the CPU side indices are always uint32_t
+enum class IndexType
+{
+	UINT16,
+	UINT32
+};
+
+// A cluster of at most MeshletBuilder::maxVertices vertices and maxTriangles triangles
+struct Meshlet
+{
+	uint32_t vertexOffset;		// first element in TinyObjShape::meshletVertices
+	uint32_t triangleOffset;	// first element in TinyObjShape::meshletTriangles
+	uint32_t vertexCount;
+	uint32_t triangleCount;
+
+	// bounding sphere
+	glm::vec3 center;
+	float radius;
+
+	// normal cone, coneCutoff is the sine of the cone half angle, 1 if the cone is too wide to cull
+	glm::vec3 coneAxis;
+	float coneCutoff;
+
+	// The whole cluster faces away from a camera at cameraPos
+	bool IsBackfacing(glm::vec3 const& cameraPos) const;
+};
+
+// A simplified level of detail, the indices reference the vertices of the full detail shape
+struct ShapeLod
+{
+	uint32_t indexOffset;	// first element in TinyObjShape::lodIndices
+	uint32_t indexCount;
+	float error;			// in model space units
+};
+
 struct TinyObjShape
 {
 	std::vector<Vertex> vertices;
 	std::vector<uint32_t> indices;
 	int materialId;
+	IndexType indexType = IndexType::UINT32;
+
+	// only filled with LoadSettings::buildMeshlets
+	std::vector<Meshlet> meshlets;
+	std::vector<uint32_t> meshletVertices;		// shape vertex indices
+	std::vector<uint8_t> meshletTriangles;		// 3 local indices per triangle into the meshlet vertices
+
+	// LOD 1..n, only filled with LoadSettings::lodCount > 0, LOD 0 is the indices array itself
+	std::vector<ShapeLod> lods;
+	std::vector<uint32_t> lodIndices;
 };
 
 struct TinyObjMaterial
 {
 	std::string diffuseTexture;
+	// Kept alive until the GPU upload, not part of the mesh cache; only one of them is set
+	ImageHandle diffuseImage;
+	std::shared_ptr<CompressedTexture const> diffuseCompressed;
 
 	TinyObjMaterial(std::string const& diffuseTexture);
 };
 
 struct LoadedModel
 {
+	std::string name;	// the source file, also the key of the model in the load report
 	std::vector<TinyObjShape> shapes;
 	std::vector<TinyObjMaterial> materials;
 };
@@ -44,10 +94,37 @@ struct ModelLoader
 	{
 		bool flipWinding = false;
 		bool ignoreMissingUVs = false;
+		bool optimizeVertexCache = false;
+		bool optimizeOverdraw = false;
+		bool optimizeVertexFetch = false;
+		bool buildMeshlets = false;
+		uint32_t lodCount = 0;
+		bool mergeByMaterial = false;
+		bool useMeshCache = true;
+		bool parallelShapes = true;
+		bool benchmarkDedup = false;
+
+		// Only the settings that change the loaded data take part in the hash
+		uint64_t Hash() const;
 	};
 
 	LoadedModel Load(std::string const& fileName, std::string const& mtlDirectory, LoadSettings const& loadsettings);
-	void CheckMaterialIds(std::vector<tinyobj::shape_t> const& shapes);
-	void LoadMaterialTextures(std::vector<TinyObjMaterial> const& materials);
+	// Load on a worker thread, the GPU upload is left to the caller's render thread
+	static std::future<LoadedModel> LoadAsync(std::string const& fileName, std::string const& mtlDirectory, LoadSettings const& loadsettings);
+	void BuildShapes(LoadedModel& loadedModel, tinyobj::attrib_t const& attrib, std::vector<tinyobj::shape_t> const& shapes, LoadSettings const& loadsettings);
+	TinyObjShape BuildShape(tinyobj::attrib_t const& attrib, tinyobj::shape_t const& shape, LoadSettings const& loadsettings);
+	void OptimizeShape(TinyObjShape& shape, LoadSettings const& loadsettings);
+	void BuildMeshlets(TinyObjShape& shape);
+	void BuildLods(TinyObjShape& shape, LoadSettings const& loadsettings);
+	void BenchmarkDedup(LoadedModel const& loadedModel);
+	uint64_t HashSources(std::vector<char> const& objData, std::string const& mtlDirectory);
+	void CheckMaterialIds(std::vector<tinyobj::shape_t> const& shapes, size_t materialCount);
+	std::vector<tinyobj::shape_t> SplitShapesByMaterial(std::vector<tinyobj::shape_t> const& shapes, bool mergeShapes);
+	void LoadMaterialTextures(std::vector<TinyObjMaterial>& materials);
+	void LoadCompressedMaterialTextures(std::vector<TinyObjMaterial>& materials, BlockFormat format);
+	void ReportModelStats(LoadedModel const& loadedModel);
 	std::string HandleDefaultTexure(fs::path const& path);
+
+	// The load report key of the model being loaded, set by Load
+	std::string assetName;
 };
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <iostream>
+#include <algorithm>
+#include <numeric>
 #include <vector>
+#include <list>
 #include <map>
 #include <set>
 #include <unordered_map>
@@ -12,6 +15,13 @@
 #include <chrono>
 #include <fstream>
 #include <filesystem>
+#include <functional>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <atomic>
 
 #include <vulkan/vulkan.hpp>
 
@@ -27,6 +37,8 @@
 #include <glm/mat4x4.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/packing.hpp>
+#include <glm/gtc/type_precision.hpp>
 #include <glm/gtx/hash.hpp>
 #include <glm/gtx/transform.hpp>
 #include <glm/gtx/string_cast.hpp>
@@ -46,6 +58,8 @@
 #include <rapidjson/rapidjson.h>
 #include <rapidjson/document.h>
 #include <rapidjson/istreamwrapper.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/prettywriter.h>
 
 #include <fmt/format.h>
 #include <fmt/ostream.h>
@@ -0,0 +1,153 @@
+#include "pixel_format.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PIXEL_FORMAT_SSE2
+#endif
+
+// az MSVC nem definial __SSSE3__-at, az /arch:AVX2 viszont magaban foglalja
+#if defined(__SSSE3__) || defined(__AVX2__)
+#define PIXEL_FORMAT_SSSE3
+#endif
+
+#if defined(PIXEL_FORMAT_SSE2)
+#include <immintrin.h>
+#endif
+
+PixelFormat PixelConverter::FromChannelCount(int channelCount)
+{
+	switch (channelCount) {
+	case 1: return PixelFormat::R8;
+	case 2: return PixelFormat::RG8;
+	case 3: return PixelFormat::RGB8;
+	case 4: return PixelFormat::RGBA8;
+	}
+
+	throw std::runtime_error("unsupported channel count");
+}
+
+int PixelConverter::GetChannelCount(PixelFormat format)
+{
+	switch (format) {
+	case PixelFormat::R8: return 1;
+	case PixelFormat::RG8: return 2;
+	case PixelFormat::RGB8: return 3;
+	case PixelFormat::RGBA8: return 4;
+	}
+
+	throw std::runtime_error("unknown pixel format");
+}
+
+int PixelConverter::GetAlphaChannel(PixelFormat format)
+{
+	switch (format) {
+	case PixelFormat::RG8: return 1;
+	case PixelFormat::RGBA8: return 3;
+	default: return -1;
+	}
+}
+
+std::string PixelConverter::GetFormatName(PixelFormat format)
+{
+	switch (format) {
+	case PixelFormat::R8: return "r8";
+	case PixelFormat::RG8: return "rg8";
+	case PixelFormat::RGB8: return "rgb8";
+	case PixelFormat::RGBA8: return "rgba8";
+	}
+
+	throw std::runtime_error("unknown pixel format");
+}
+
+void PixelConverter::ExpandToRgba(uint8_t const* source, PixelFormat format, uint8_t* target, size_t texelCount)
+{
+	switch (format) {
+	case PixelFormat::R8: ExpandR8(source, target, texelCount); break;
+	case PixelFormat::RG8: ExpandRG8(source, target, texelCount); break;
+	case PixelFormat::RGB8: ExpandRGB8(source, target, texelCount); break;
+	case PixelFormat::RGBA8: std::memcpy(target, source, 4 * texelCount); break;
+	}
+}
+
+std::vector<uint8_t> PixelConverter::ExpandToRgba(uint8_t const* source, PixelFormat format, size_t texelCount)
+{
+	std::vector<uint8_t> pixels(4 * texelCount);
+	ExpandToRgba(source, format, pixels.data(), texelCount);
+	return pixels;
+}
+
+void PixelConverter::ExpandR8(uint8_t const* source, uint8_t* target, size_t texelCount)
+{
+	size_t texelIdx = 0;
+
+#if defined(PIXEL_FORMAT_SSE2)
+	// 16 texel egyszerre: a szurke byte ketszeri duplazasa adja az RGB-t, az alpha byte-ot a maszk allitja 255-re
+	auto alphaMask = _mm_set1_epi32(static_cast<int>(0xff000000u));
+	for (; texelIdx + 16 <= texelCount; texelIdx += 16) {
+		auto gray = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source + texelIdx));
+		auto grayLo = _mm_unpacklo_epi8(gray, gray);
+		auto grayHi = _mm_unpackhi_epi8(gray, gray);
+
+		auto texels = reinterpret_cast<__m128i*>(target + 4 * texelIdx);
+		_mm_storeu_si128(texels + 0, _mm_or_si128(_mm_unpacklo_epi16(grayLo, grayLo), alphaMask));
+		_mm_storeu_si128(texels + 1, _mm_or_si128(_mm_unpackhi_epi16(grayLo, grayLo), alphaMask));
+		_mm_storeu_si128(texels + 2, _mm_or_si128(_mm_unpacklo_epi16(grayHi, grayHi), alphaMask));
+		_mm_storeu_si128(texels + 3, _mm_or_si128(_mm_unpackhi_epi16(grayHi, grayHi), alphaMask));
+	}
+#endif
+
+	for (; texelIdx < texelCount; texelIdx++) {
+		auto texel = target + 4 * texelIdx;
+		texel[0] = texel[1] = texel[2] = source[texelIdx];
+		texel[3] = 255;
+	}
+}
+
+void PixelConverter::ExpandRG8(uint8_t const* source, uint8_t* target, size_t texelCount)
+{
+	size_t texelIdx = 0;
+
+#if defined(PIXEL_FORMAT_SSE2)
+	// 8 texel egyszerre: a (szurke, alpha) par duplazasa utan (g, a, g, a) lesz, az 1. byte helyere a szurke kerul
+	auto keepMask = _mm_set1_epi32(static_cast<int>(0xffff00ffu));
+	auto grayMask = _mm_set1_epi32(0x000000ff);
+	for (; texelIdx + 8 <= texelCount; texelIdx += 8) {
+		auto grayAlpha = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source + 2 * texelIdx));
+
+		auto texels = reinterpret_cast<__m128i*>(target + 4 * texelIdx);
+		for (int half = 0; half < 2; half++) {
+			auto pairs = half == 0 ? _mm_unpacklo_epi16(grayAlpha, grayAlpha) : _mm_unpackhi_epi16(grayAlpha, grayAlpha);
+			auto gray = _mm_slli_epi32(_mm_and_si128(pairs, grayMask), 8);
+			_mm_storeu_si128(texels + half, _mm_or_si128(_mm_and_si128(pairs, keepMask), gray));
+		}
+	}
+#endif
+
+	for (; texelIdx < texelCount; texelIdx++) {
+		auto texel = target + 4 * texelIdx;
+		texel[0] = texel[1] = texel[2] = source[2 * texelIdx];
+		texel[3] = source[2 * texelIdx + 1];
+	}
+}
+
+void PixelConverter::ExpandRGB8(uint8_t const* source, uint8_t* target, size_t texelCount)
+{
+	size_t texelIdx = 0;
+
+#if defined(PIXEL_FORMAT_SSSE3)
+	// 4 texel egyszerre egy pshufb-vel, a 16 byte-os olvasas miatt az utolso 6 texel mar a skalar agra marad
+	auto shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+	auto alphaMask = _mm_set1_epi32(static_cast<int>(0xff000000u));
+	for (; texelIdx + 6 <= texelCount; texelIdx += 4) {
+		auto rgb = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source + 3 * texelIdx));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(target + 4 * texelIdx), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alphaMask));
+	}
+#endif
+
+	for (; texelIdx < texelCount; texelIdx++) {
+		auto texel = target + 4 * texelIdx;
+		texel[0] = source[3 * texelIdx];
+		texel[1] = source[3 * texelIdx + 1];
+		texel[2] = source[3 * texelIdx + 2];
+		texel[3] = 255;
+	}
+}
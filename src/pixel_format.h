@@ -0,0 +1,23 @@
+#pragma once
+#include "pch.h"
+
+// The channel layouts stbi decodes to, one byte per channel: gray, gray + alpha, RGB, RGBA
+enum struct PixelFormat { R8, RG8, RGB8, RGBA8 };
+
+struct PixelConverter
+{
+	static PixelFormat FromChannelCount(int channelCount);
+	static int GetChannelCount(PixelFormat format);
+	// -1 if the format has no alpha
+	static int GetAlphaChannel(PixelFormat format);
+	static std::string GetFormatName(PixelFormat format);
+
+	// Gray is replicated into RGB, a missing alpha becomes 255
+	static void ExpandToRgba(uint8_t const* source, PixelFormat format, uint8_t* target, size_t texelCount);
+	static std::vector<uint8_t> ExpandToRgba(uint8_t const* source, PixelFormat format, size_t texelCount);
+
+private:
+	static void ExpandR8(uint8_t const* source, uint8_t* target, size_t texelCount);
+	static void ExpandRG8(uint8_t const* source, uint8_t* target, size_t texelCount);
+	static void ExpandRGB8(uint8_t const* source, uint8_t* target, size_t texelCount);
+};
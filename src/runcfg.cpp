@@ -5,6 +5,12 @@
 #endif
 
 Runcfg::Runcfg() :
+	imageCacheBudget{ 0 },
+	imageDiskCache{ false },
+	packedVertices{ false },
+	interleavedVertices{ false },
+	geometryArena{ false },
+	multiDrawIndirect{ false },
 	initialized{ false }
 {
 	projectSourceDir = PROJECT_SOURCE_DIR;
@@ -34,4 +40,13 @@ void Runcfg::Init()
 	currentRendererName = d["renderers"][currentRenderer.c_str()]["name"].GetString();
 	shadersDir = projectSourceDir / d["shadersDir"].GetString();
 	texturesDir = projectSourceDir / d["texturesDir"].GetString();
+	loadReportPath = projectSourceDir / d["loadReport"].GetString();
+	packedVertices = d["packedVertices"].GetBool();
+	interleavedVertices = d["interleavedVertices"].GetBool();
+	geometryArena = d["geometryArena"].GetBool();
+	multiDrawIndirect = d["multiDrawIndirect"].GetBool();
+	imageCacheBudget = static_cast<size_t>(d["imageCacheBudgetMB"].GetUint64()) * 1024 * 1024;
+	imageDiskCache = d["imageDiskCache"].GetBool();
+	textureFormat = d["textureFormat"].GetString();
+	blockTextureLayout = d["blockTextureLayout"].GetString();
 }
@@ -7,6 +7,15 @@ struct Runcfg
 	std::string currentRendererName;
 	fs::path shadersDir;
 	fs::path texturesDir;
+	fs::path loadReportPath;
+	size_t imageCacheBudget;
+	bool imageDiskCache;
+	std::string textureFormat;
+	std::string blockTextureLayout;
+	bool packedVertices;
+	bool interleavedVertices;
+	bool geometryArena;
+	bool multiDrawIndirect;
 
 	static Runcfg& Instance();
 	void Init();
@@ -0,0 +1,197 @@
+#include "texture_cache.h"
+
+#include "mapped_file.h"
+#include "utils.h"
+
+// az enkoder valtozasakor is novelni kell, kulonben a regi minosegu blokkok maradnak a cache-ben
+static constexpr std::array<char, 8> textureCacheMagic = { 'M', 'C', 'V', 'K', 'T', 'E', 'X', 'B' };
+static constexpr uint32_t textureCacheVersion = 1;
+static constexpr uint64_t textureCacheAlignment = 16;
+static constexpr uint32_t maxLevelCount = 32;
+
+struct TextureCacheHeader
+{
+	std::array<char, 8> magic;
+	uint32_t version;
+	uint32_t format;
+	uint32_t width;
+	uint32_t height;
+	uint32_t levelCount;
+	uint32_t reserved;
+	uint64_t sourceHash;
+};
+
+struct TextureCacheLevel
+{
+	uint64_t offset;
+	uint64_t byteCount;
+	uint32_t width;
+	uint32_t height;
+};
+
+static uint64_t AlignUp(uint64_t offset)
+{
+	return (offset + textureCacheAlignment - 1) & ~(textureCacheAlignment - 1);
+}
+
+std::string TextureCache::GetCachePath(std::string const& imagePath, BlockFormat format)
+{
+	return imagePath + "." + TextureCompressor::GetFormatName(format) + ".texcache";
+}
+
+std::optional<CompressedTexture> TextureCache::TryLoad(std::string const& cachePath, uint64_t sourceHash, BlockFormat format)
+{
+	if (!fs::is_regular_file(cachePath)) {
+		return std::nullopt;
+	}
+
+	auto reject = [&cachePath](std::string const& reason) -> std::optional<CompressedTexture> {
+		theLogger.LogInfo("Texture cache {} not used: {}", cachePath, reason);
+		return std::nullopt;
+	};
+
+	try {
+		MappedFile mappedFile(cachePath);
+		auto data = mappedFile.Data();
+		auto size = static_cast<uint64_t>(mappedFile.Size());
+
+		auto isInRange = [size](uint64_t offset, uint64_t byteCount) {
+			return offset <= size && byteCount <= size - offset;
+		};
+
+		if (!isInRange(0, sizeof(TextureCacheHeader))) return reject("truncated header");
+
+		TextureCacheHeader header;
+		std::memcpy(&header, data, sizeof(header));
+
+		if (header.magic != textureCacheMagic) return reject("invalid magic");
+		if (header.version != textureCacheVersion) return reject("outdated format");
+		if (header.format != static_cast<uint32_t>(format)) return reject("format changed");
+		if (header.sourceHash != sourceHash) return reject("source changed");
+		if (header.levelCount == 0 || header.levelCount > maxLevelCount) return reject("invalid level count");
+
+		uint64_t levelTableOffset = sizeof(TextureCacheHeader);
+		if (!isInRange(levelTableOffset, sizeof(TextureCacheLevel) * header.levelCount)) return reject("truncated level table");
+
+		CompressedTexture texture;
+		texture.format = format;
+		texture.levels.reserve(header.levelCount);
+
+		for (uint32_t levelIdx = 0; levelIdx < header.levelCount; levelIdx++) {
+			TextureCacheLevel entry;
+			std::memcpy(&entry, data + levelTableOffset + sizeof(TextureCacheLevel) * levelIdx, sizeof(entry));
+
+			// a szintek meretet a lanc es a formatum egyertelmuen meghatarozza
+			glm::ivec2 expectedSize = glm::max(glm::ivec2(header.width >> levelIdx, header.height >> levelIdx), glm::ivec2(1));
+			if (entry.width != static_cast<uint32_t>(expectedSize.x) || entry.height != static_cast<uint32_t>(expectedSize.y)) return reject("invalid level size");
+			if (entry.byteCount != TextureCompressor::GetLevelSize(format, expectedSize)) return reject("invalid level byte count");
+			if (!isInRange(entry.offset, entry.byteCount)) return reject("truncated level data");
+
+			auto& level = texture.levels.emplace_back();
+			level.size = expectedSize;
+			level.data.assign(data + entry.offset, data + entry.offset + entry.byteCount);
+		}
+
+		return texture;
+	}
+	catch (std::exception& e) {
+		theLogger.LogWarning("Texture cache {} could not be read: {}", cachePath, e.what());
+		return std::nullopt;
+	}
+}
+
+void TextureCache::Store(std::string const& cachePath, CompressedTexture const& texture, uint64_t sourceHash)
+{
+	if (texture.levels.empty()) return;
+
+	TextureCacheHeader header{};
+	header.magic = textureCacheMagic;
+	header.version = textureCacheVersion;
+	header.format = static_cast<uint32_t>(texture.format);
+	header.width = static_cast<uint32_t>(texture.levels[0].size.x);
+	header.height = static_cast<uint32_t>(texture.levels[0].size.y);
+	header.levelCount = static_cast<uint32_t>(texture.levels.size());
+	header.sourceHash = sourceHash;
+
+	std::vector<TextureCacheLevel> levelTable(texture.levels.size());
+
+	// eloszor kiosztjuk az offset-eket, utana egyben irjuk ki az egeszet
+	uint64_t fileSize = sizeof(TextureCacheHeader) + sizeof(TextureCacheLevel) * levelTable.size();
+	for (size_t levelIdx = 0; levelIdx < texture.levels.size(); levelIdx++) {
+		auto const& level = texture.levels[levelIdx];
+		auto& entry = levelTable[levelIdx];
+		entry.offset = AlignUp(fileSize);
+		entry.byteCount = level.data.size();
+		entry.width = static_cast<uint32_t>(level.size.x);
+		entry.height = static_cast<uint32_t>(level.size.y);
+		fileSize = entry.offset + entry.byteCount;
+	}
+
+	std::vector<char> buffer(fileSize, 0);
+	std::memcpy(buffer.data(), &header, sizeof(header));
+	std::memcpy(buffer.data() + sizeof(header), levelTable.data(), sizeof(TextureCacheLevel) * levelTable.size());
+
+	for (size_t levelIdx = 0; levelIdx < texture.levels.size(); levelIdx++) {
+		auto const& level = texture.levels[levelIdx];
+		std::memcpy(buffer.data() + levelTable[levelIdx].offset, level.data.data(), level.data.size());
+	}
+
+	// ideiglenes fajlba irunk, hogy egy felbeszakadt iras ne hagyjon hibas cache-t maga utan
+	auto tempPath = cachePath + ".tmp";
+	{
+		std::ofstream ofs(tempPath, std::ios::binary | std::ios::trunc);
+		if (!ofs.is_open()) {
+			theLogger.LogWarning("Texture cache {} could not be written", cachePath);
+			return;
+		}
+
+		ofs.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		if (!ofs) {
+			theLogger.LogWarning("Texture cache {} could not be written", cachePath);
+			return;
+		}
+	}
+
+	std::error_code errorCode;
+	fs::rename(tempPath, cachePath, errorCode);
+	if (errorCode) {
+		theLogger.LogWarning("Texture cache {} could not be written: {}", cachePath, errorCode.message());
+		fs::remove(tempPath, errorCode);
+		return;
+	}
+
+	theLogger.LogInfo("Texture cache {} written ({} bytes)", cachePath, buffer.size());
+}
+
+std::shared_ptr<CompressedTexture const> TextureCache::LoadOrCompress(std::string const& imagePath, BlockFormat format)
+{
+	auto key = ImageCache::NormalizePath(imagePath);
+	auto cachePath = GetCachePath(key, format);
+
+	uint64_t sourceHash;
+	{
+		MappedFile sourceFile(key);
+		sourceHash = Utils::HashBytes(sourceFile.Data(), sourceFile.Size());
+	}
+
+	if (auto cachedTexture = TryLoad(cachePath, sourceHash, format)) {
+		return std::make_shared<CompressedTexture const>(std::move(*cachedTexture));
+	}
+
+	auto timerStart = std::chrono::high_resolution_clock::now();
+
+	auto image = theImageCache.Load(key);
+	auto texture = TextureCompressor::Compress(*image, format);
+
+	auto timerStop = std::chrono::high_resolution_clock::now();
+	auto compressTime = std::chrono::duration<double, std::milli>(timerStop - timerStart).count();
+
+	// a legnagyobb szint minosege a dekoderrel visszaellenorizve
+	auto psnr = TextureCompressor::ComputePsnr(MipLevel{ image->imageSize, image->GetLevelRgba(0) }, texture.levels[0], format);
+	theLogger.LogInfo("Texture {} compressed to {} in {:.2f} ms: {} levels, {} -> {} bytes, PSNR {:.2f} dB",
+		key, TextureCompressor::GetFormatName(format), compressTime, texture.levels.size(), image->GetSizeBytes(), texture.GetSizeBytes(), psnr);
+
+	Store(cachePath, texture, sourceHash);
+
+	return std::make_shared<CompressedTexture const>(std::move(texture));
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include "pch.h"
+
+#include "texture_compressor.h"
+
+// Versioned binary cache of block compressed mip chains (a minimal KTX2-like container), stored next to the source image
+struct TextureCache
+{
+	static std::string GetCachePath(std::string const& imagePath, BlockFormat format);
+	static std::optional<CompressedTexture> TryLoad(std::string const& cachePath, uint64_t sourceHash, BlockFormat format);
+	static void Store(std::string const& cachePath, CompressedTexture const& texture, uint64_t sourceHash);
+
+	// The compressed image, encoded through theImageCache and stored on the first use; the source file hash is the cache key
+	static std::shared_ptr<CompressedTexture const> LoadOrCompress(std::string const& imagePath, BlockFormat format);
+};
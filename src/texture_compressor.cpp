@@ -0,0 +1,635 @@
+#include "texture_compressor.h"
+
+#include "thread_pool.h"
+
+using Block = TextureCompressor::Block;
+
+static constexpr int refineIterationCount = 2;
+static constexpr std::array<int, 16> bc7Weights = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// A blokk bitjei LSB-tol kezdve, a BC7 mezok nincsenek bajthatarra igazitva
+struct BitWriter
+{
+	uint8_t* output;
+	int position = 0;
+
+	void Write(uint32_t value, int bitCount)
+	{
+		for (int i = 0; i < bitCount; i++, position++) {
+			if ((value >> i) & 1u) output[position >> 3] |= static_cast<uint8_t>(1u << (position & 7));
+		}
+	}
+};
+
+struct BitReader
+{
+	uint8_t const* input;
+	int position = 0;
+
+	uint32_t Read(int bitCount)
+	{
+		uint32_t value = 0;
+		for (int i = 0; i < bitCount; i++, position++) {
+			value |= static_cast<uint32_t>((input[position >> 3] >> (position & 7)) & 1u) << i;
+		}
+		return value;
+	}
+};
+
+static glm::vec4 ComputeMean(Block const& block)
+{
+	glm::vec4 sum{ 0.0f };
+	for (auto const& texel : block) {
+		sum += glm::vec4(texel);
+	}
+	return sum / static_cast<float>(block.size());
+}
+
+// A kovariancia matrix legnagyobb sajatertekehez tartozo irany hatvanyiteracioval, nulla ha a blokk egyszinu
+static glm::vec4 ComputePrincipalAxis(Block const& block, glm::vec4 const& mean, bool isUsingAlpha)
+{
+	glm::mat4 covariance{ 0.0f };
+	for (auto const& texel : block) {
+		auto delta = glm::vec4(texel) - mean;
+		if (!isUsingAlpha) delta.w = 0.0f;
+		covariance += glm::outerProduct(delta, delta);
+	}
+
+	// a legnagyobb szorasu komponens oszlopa nem lehet meroleges a fo iranyra
+	int startColumn = 0;
+	for (int i = 1; i < 4; i++) {
+		if (covariance[i][i] > covariance[startColumn][startColumn]) startColumn = i;
+	}
+
+	auto axis = covariance[startColumn];
+	for (int iteration = 0; iteration < 8; iteration++) {
+		auto length = glm::length(axis);
+		if (length < 1e-6f) return glm::vec4{ 0.0f };
+
+		axis = covariance * (axis / length);
+	}
+
+	auto length = glm::length(axis);
+	return length < 1e-6f ? glm::vec4{ 0.0f } : axis / length;
+}
+
+// A texel-ek vetulete a fo tengelyre, a ket szelsoertek lesz a ket vegpont
+static std::pair<glm::vec4, glm::vec4> ComputeEndpoints(Block const& block, bool isUsingAlpha)
+{
+	auto mean = ComputeMean(block);
+	auto axis = ComputePrincipalAxis(block, mean, isUsingAlpha);
+
+	float minProjection = 0.0f, maxProjection = 0.0f;
+	for (auto const& texel : block) {
+		auto projection = glm::dot(glm::vec4(texel) - mean, axis);
+		minProjection = std::min(minProjection, projection);
+		maxProjection = std::max(maxProjection, projection);
+	}
+
+	auto endpoint0 = glm::clamp(mean + axis * maxProjection, 0.0f, 255.0f);
+	auto endpoint1 = glm::clamp(mean + axis * minProjection, 0.0f, 255.0f);
+	return { endpoint0, endpoint1 };
+}
+
+// Legkisebb negyzetes vegpontok rogzitett indexekhez, weights a vegpont1 sulya texelenkent
+static bool SolveEndpoints(Block const& block, std::array<float, 16> const& weights, glm::vec4& endpoint0, glm::vec4& endpoint1)
+{
+	float weight00 = 0.0f, weight01 = 0.0f, weight11 = 0.0f;
+	glm::vec4 texel0{ 0.0f }, texel1{ 0.0f };
+
+	for (size_t texelIdx = 0; texelIdx < block.size(); texelIdx++) {
+		auto weight1 = weights[texelIdx];
+		auto weight0 = 1.0f - weight1;
+		auto texel = glm::vec4(block[texelIdx]);
+
+		weight00 += weight0 * weight0;
+		weight01 += weight0 * weight1;
+		weight11 += weight1 * weight1;
+		texel0 += texel * weight0;
+		texel1 += texel * weight1;
+	}
+
+	auto determinant = weight00 * weight11 - weight01 * weight01;
+	if (std::abs(determinant) < 1e-6f) return false;
+
+	endpoint0 = glm::clamp((texel0 * weight11 - texel1 * weight01) / determinant, 0.0f, 255.0f);
+	endpoint1 = glm::clamp((texel1 * weight00 - texel0 * weight01) / determinant, 0.0f, 255.0f);
+	return true;
+}
+
+static uint16_t PackRgb565(glm::vec4 const& color)
+{
+	auto r = static_cast<uint16_t>(std::lround(color.r * 31.0f / 255.0f));
+	auto g = static_cast<uint16_t>(std::lround(color.g * 63.0f / 255.0f));
+	auto b = static_cast<uint16_t>(std::lround(color.b * 31.0f / 255.0f));
+	return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+static glm::ivec4 UnpackRgb565(uint16_t color)
+{
+	int r = (color >> 11) & 31;
+	int g = (color >> 5) & 63;
+	int b = color & 31;
+	return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255 };
+}
+
+// Az enkoder ugyanazt a palettat hasznalja, mint a dekoder, igy a legkozelebbi szin tenyleg a legkozelebbi
+static std::array<glm::ivec4, 4> GetColorPalette(uint16_t color0, uint16_t color1, bool isFourColorMode)
+{
+	std::array<glm::ivec4, 4> palette;
+	palette[0] = UnpackRgb565(color0);
+	palette[1] = UnpackRgb565(color1);
+
+	if (isFourColorMode) {
+		palette[2] = (2 * palette[0] + palette[1]) / 3;
+		palette[3] = (palette[0] + 2 * palette[1]) / 3;
+	}
+	else {
+		palette[2] = (palette[0] + palette[1]) / 2;
+		palette[3] = { 0, 0, 0, 0 };
+	}
+
+	palette[2].a = 255;
+	if (isFourColorMode) palette[3].a = 255;
+
+	return palette;
+}
+
+static std::array<int, 8> GetAlphaPalette(int alpha0, int alpha1)
+{
+	std::array<int, 8> palette;
+	palette[0] = alpha0;
+	palette[1] = alpha1;
+
+	if (alpha0 > alpha1) {
+		for (int i = 1; i <= 6; i++) {
+			palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7;
+		}
+	}
+	else {
+		for (int i = 1; i <= 4; i++) {
+			palette[i + 1] = ((5 - i) * alpha0 + i * alpha1) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	return palette;
+}
+
+struct ColorEncoding
+{
+	uint16_t color0;
+	uint16_t color1;
+	std::array<uint32_t, 16> indices;
+	int error;
+};
+
+static ColorEncoding EncodeColorEndpoints(Block const& block, glm::vec4 const& endpoint0, glm::vec4 const& endpoint1)
+{
+	ColorEncoding encoding{};
+	encoding.color0 = PackRgb565(endpoint0);
+	encoding.color1 = PackRgb565(endpoint1);
+
+	// color0 > color1 eseten negy szinu a blokk, BC3-ban mindig az
+	if (encoding.color0 < encoding.color1) std::swap(encoding.color0, encoding.color1);
+
+	// egyenlo vegpontoknal minden index 0, az a color0
+	auto palette = GetColorPalette(encoding.color0, encoding.color1, true);
+	auto paletteSize = encoding.color0 == encoding.color1 ? 1u : 4u;
+
+	for (size_t texelIdx = 0; texelIdx < block.size(); texelIdx++) {
+		auto texel = glm::ivec4(block[texelIdx]);
+		auto bestDistance = std::numeric_limits<int>::max();
+
+		for (uint32_t i = 0; i < paletteSize; i++) {
+			auto delta = palette[i] - texel;
+			auto distance = delta.r * delta.r + delta.g * delta.g + delta.b * delta.b;
+			if (distance < bestDistance) {
+				bestDistance = distance;
+				encoding.indices[texelIdx] = i;
+			}
+		}
+
+		encoding.error += bestDistance;
+	}
+
+	return encoding;
+}
+
+struct Bc7Encoding
+{
+	std::array<glm::ivec4, 2> quantized;
+	std::array<int, 2> pBits;
+	std::array<int, 16> indices;
+	int error;
+};
+
+static int Bc7Interpolate(int endpoint0, int endpoint1, int weight)
+{
+	return ((64 - weight) * endpoint0 + weight * endpoint1 + 32) >> 6;
+}
+
+// 7 bites vegpont + kozos also p-bit, a ketto kozul a kisebb hibaju
+static void QuantizeBc7Endpoint(glm::vec4 const& endpoint, glm::ivec4& quantized, int& pBit)
+{
+	auto bestError = std::numeric_limits<float>::max();
+
+	for (int candidatePBit = 0; candidatePBit < 2; candidatePBit++) {
+		glm::ivec4 candidate;
+		float error = 0.0f;
+
+		for (int c = 0; c < 4; c++) {
+			candidate[c] = std::clamp(static_cast<int>(std::lround((endpoint[c] - candidatePBit) / 2.0f)), 0, 127);
+			auto reconstructed = static_cast<float>((candidate[c] << 1) | candidatePBit);
+			error += (reconstructed - endpoint[c]) * (reconstructed - endpoint[c]);
+		}
+
+		if (error < bestError) {
+			bestError = error;
+			quantized = candidate;
+			pBit = candidatePBit;
+		}
+	}
+}
+
+static Bc7Encoding EncodeBc7Endpoints(Block const& block, glm::vec4 const& endpoint0, glm::vec4 const& endpoint1)
+{
+	Bc7Encoding encoding{};
+	QuantizeBc7Endpoint(endpoint0, encoding.quantized[0], encoding.pBits[0]);
+	QuantizeBc7Endpoint(endpoint1, encoding.quantized[1], encoding.pBits[1]);
+
+	auto expanded0 = encoding.quantized[0] * 2 + encoding.pBits[0];
+	auto expanded1 = encoding.quantized[1] * 2 + encoding.pBits[1];
+
+	std::array<glm::ivec4, 16> palette;
+	for (int i = 0; i < 16; i++) {
+		for (int c = 0; c < 4; c++) {
+			palette[i][c] = Bc7Interpolate(expanded0[c], expanded1[c], bc7Weights[i]);
+		}
+	}
+
+	for (size_t texelIdx = 0; texelIdx < block.size(); texelIdx++) {
+		auto texel = glm::ivec4(block[texelIdx]);
+		auto bestDistance = std::numeric_limits<int>::max();
+
+		for (int i = 0; i < 16; i++) {
+			auto delta = palette[i] - texel;
+			auto distance = delta.r * delta.r + delta.g * delta.g + delta.b * delta.b + delta.a * delta.a;
+			if (distance < bestDistance) {
+				bestDistance = distance;
+				encoding.indices[texelIdx] = i;
+			}
+		}
+
+		encoding.error += bestDistance;
+	}
+
+	return encoding;
+}
+
+size_t CompressedTexture::GetSizeBytes() const
+{
+	size_t sizeBytes = 0;
+	for (auto const& level : levels) {
+		sizeBytes += level.data.size();
+	}
+	return sizeBytes;
+}
+
+std::optional<BlockFormat> TextureCompressor::ParseFormat(std::string const& name)
+{
+	if (name == "rgba8") return std::nullopt;
+	if (name == "bc1") return BlockFormat::BC1;
+	if (name == "bc3") return BlockFormat::BC3;
+	if (name == "bc7") return BlockFormat::BC7;
+
+	throw std::runtime_error("unknown texture format: " + name);
+}
+
+std::string TextureCompressor::GetFormatName(BlockFormat format)
+{
+	switch (format) {
+	case BlockFormat::BC1: return "bc1";
+	case BlockFormat::BC3: return "bc3";
+	case BlockFormat::BC7: return "bc7";
+	}
+
+	throw std::runtime_error("unknown block format");
+}
+
+size_t TextureCompressor::GetBlockSize(BlockFormat format)
+{
+	return format == BlockFormat::BC1 ? 8 : 16;
+}
+
+size_t TextureCompressor::GetLevelSize(BlockFormat format, glm::ivec2 size)
+{
+	auto blocksX = static_cast<size_t>((size.x + blockDimension - 1) / blockDimension);
+	auto blocksY = static_cast<size_t>((size.y + blockDimension - 1) / blockDimension);
+	return blocksX * blocksY * GetBlockSize(format);
+}
+
+CompressedTexture TextureCompressor::Compress(Image const& image, BlockFormat format)
+{
+	CompressedTexture texture;
+	texture.format = format;
+
+	// a mip lanc a dekodolaskor elkeszult, a blokk kodolo RGBA-t var
+	for (uint32_t levelIdx = 0; levelIdx < image.GetLevelCount(); levelIdx++) {
+		MipLevel level{ image.GetLevelSize(levelIdx), image.GetLevelRgba(levelIdx) };
+		texture.levels.push_back(CompressLevel(level, format));
+	}
+
+	return texture;
+}
+
+CompressedLevel TextureCompressor::CompressLevel(MipLevel const& level, BlockFormat format)
+{
+	auto blocksX = (level.size.x + blockDimension - 1) / blockDimension;
+	auto blocksY = (level.size.y + blockDimension - 1) / blockDimension;
+	auto blockSize = GetBlockSize(format);
+
+	CompressedLevel compressedLevel;
+	compressedLevel.size = level.size;
+	compressedLevel.data.resize(GetLevelSize(format, level.size));
+
+	// a blokk sorok egymastol fuggetlenek, mindegyik a sajat helyere ir
+	theThreadPool.ParallelFor(static_cast<size_t>(blocksY), [&](size_t blockY) {
+		Block block;
+
+		for (int blockX = 0; blockX < blocksX; blockX++) {
+			// a szelso, nem teljes blokkokban az utolso sor / oszlop ismetlodik
+			for (int y = 0; y < blockDimension; y++) {
+				for (int x = 0; x < blockDimension; x++) {
+					auto texelX = std::min(blockX * blockDimension + x, level.size.x - 1);
+					auto texelY = std::min(static_cast<int>(blockY) * blockDimension + y, level.size.y - 1);
+					auto texel = level.pixels.data() + 4 * (static_cast<size_t>(texelY) * level.size.x + texelX);
+					block[y * blockDimension + x] = { texel[0], texel[1], texel[2], texel[3] };
+				}
+			}
+
+			auto output = compressedLevel.data.data() + (blockY * blocksX + blockX) * blockSize;
+			switch (format) {
+			case BlockFormat::BC1: EncodeBc1(block, output); break;
+			case BlockFormat::BC3: EncodeBc3(block, output); break;
+			case BlockFormat::BC7: EncodeBc7(block, output); break;
+			}
+		}
+	});
+
+	return compressedLevel;
+}
+
+MipLevel TextureCompressor::DecompressLevel(CompressedLevel const& compressedLevel, BlockFormat format)
+{
+	auto blocksX = (compressedLevel.size.x + blockDimension - 1) / blockDimension;
+	auto blocksY = (compressedLevel.size.y + blockDimension - 1) / blockDimension;
+	auto blockSize = GetBlockSize(format);
+
+	if (compressedLevel.data.size() != GetLevelSize(format, compressedLevel.size)) throw std::runtime_error("compressed level size mismatch");
+
+	MipLevel level;
+	level.size = compressedLevel.size;
+	level.pixels.resize(size_t{ 4 } * level.size.x * level.size.y);
+
+	Block block;
+	for (int blockY = 0; blockY < blocksY; blockY++) {
+		for (int blockX = 0; blockX < blocksX; blockX++) {
+			auto input = compressedLevel.data.data() + (static_cast<size_t>(blockY) * blocksX + blockX) * blockSize;
+			switch (format) {
+			case BlockFormat::BC1: DecodeBc1(input, block); break;
+			case BlockFormat::BC3: DecodeBc3(input, block); break;
+			case BlockFormat::BC7: DecodeBc7(input, block); break;
+			}
+
+			for (int y = 0; y < blockDimension; y++) {
+				for (int x = 0; x < blockDimension; x++) {
+					auto texelX = blockX * blockDimension + x;
+					auto texelY = blockY * blockDimension + y;
+					if (texelX >= level.size.x || texelY >= level.size.y) continue;
+
+					auto const& decoded = block[y * blockDimension + x];
+					auto texel = level.pixels.data() + 4 * (static_cast<size_t>(texelY) * level.size.x + texelX);
+					texel[0] = decoded.r;
+					texel[1] = decoded.g;
+					texel[2] = decoded.b;
+					texel[3] = decoded.a;
+				}
+			}
+		}
+	}
+
+	return level;
+}
+
+double TextureCompressor::ComputePsnr(MipLevel const& source, CompressedLevel const& compressedLevel, BlockFormat format)
+{
+	auto decoded = DecompressLevel(compressedLevel, format);
+	if (decoded.pixels.size() != source.pixels.size()) throw std::runtime_error("level size mismatch");
+
+	double squaredErrorSum = 0.0;
+	for (size_t i = 0; i < source.pixels.size(); i++) {
+		auto difference = static_cast<double>(source.pixels[i]) - decoded.pixels[i];
+		squaredErrorSum += difference * difference;
+	}
+
+	auto meanSquaredError = squaredErrorSum / std::max<size_t>(source.pixels.size(), 1);
+	if (meanSquaredError <= 0.0) return std::numeric_limits<double>::infinity();
+
+	return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+}
+
+void TextureCompressor::EncodeBc1(Block const& block, uint8_t* output)
+{
+	EncodeColorBlock(block, output);
+}
+
+void TextureCompressor::EncodeBc3(Block const& block, uint8_t* output)
+{
+	EncodeAlphaBlock(block, output);
+	EncodeColorBlock(block, output + 8);
+}
+
+void TextureCompressor::EncodeBc7(Block const& block, uint8_t* output)
+{
+	auto [endpoint0, endpoint1] = ComputeEndpoints(block, true);
+	auto best = EncodeBc7Endpoints(block, endpoint0, endpoint1);
+
+	// a fo tengely vegpontjait a kapott indexekhez illesztjuk, amig javul
+	for (int iteration = 0; iteration < refineIterationCount && best.error > 0; iteration++) {
+		std::array<float, 16> weights;
+		for (size_t texelIdx = 0; texelIdx < block.size(); texelIdx++) {
+			weights[texelIdx] = bc7Weights[best.indices[texelIdx]] / 64.0f;
+		}
+
+		if (!SolveEndpoints(block, weights, endpoint0, endpoint1)) break;
+
+		auto candidate = EncodeBc7Endpoints(block, endpoint0, endpoint1);
+		if (candidate.error >= best.error) break;
+		best = candidate;
+	}
+
+	// az elso index felso bitje nincs eltarolva, ezert annak 0-nak kell lennie; a sulyok szimmetrikusak, a csere nem ront
+	if (best.indices[0] >= 8) {
+		std::swap(best.quantized[0], best.quantized[1]);
+		std::swap(best.pBits[0], best.pBits[1]);
+		for (auto& index : best.indices) {
+			index = 15 - index;
+		}
+	}
+
+	std::fill(output, output + 16, uint8_t{ 0 });
+	BitWriter writer{ output };
+
+	writer.Write(1u << 6, 7);
+	for (int c = 0; c < 4; c++) {
+		writer.Write(best.quantized[0][c], 7);
+		writer.Write(best.quantized[1][c], 7);
+	}
+	writer.Write(best.pBits[0], 1);
+	writer.Write(best.pBits[1], 1);
+
+	writer.Write(best.indices[0], 3);
+	for (size_t texelIdx = 1; texelIdx < best.indices.size(); texelIdx++) {
+		writer.Write(best.indices[texelIdx], 4);
+	}
+}
+
+void TextureCompressor::DecodeBc1(uint8_t const* input, Block& block)
+{
+	DecodeColorBlock(input, block, false);
+}
+
+void TextureCompressor::DecodeBc3(uint8_t const* input, Block& block)
+{
+	DecodeColorBlock(input + 8, block, true);
+	DecodeAlphaBlock(input, block);
+}
+
+void TextureCompressor::DecodeBc7(uint8_t const* input, Block& block)
+{
+	BitReader reader{ input };
+	if (reader.Read(7) != (1u << 6)) throw std::runtime_error("only BC7 mode 6 blocks are supported");
+
+	std::array<glm::ivec4, 2> endpoints;
+	for (int c = 0; c < 4; c++) {
+		endpoints[0][c] = static_cast<int>(reader.Read(7));
+		endpoints[1][c] = static_cast<int>(reader.Read(7));
+	}
+
+	int pBit0 = static_cast<int>(reader.Read(1));
+	int pBit1 = static_cast<int>(reader.Read(1));
+	endpoints[0] = endpoints[0] * 2 + pBit0;
+	endpoints[1] = endpoints[1] * 2 + pBit1;
+
+	for (size_t texelIdx = 0; texelIdx < block.size(); texelIdx++) {
+		auto index = static_cast<int>(reader.Read(texelIdx == 0 ? 3 : 4));
+		for (int c = 0; c < 4; c++) {
+			block[texelIdx][c] = static_cast<uint8_t>(Bc7Interpolate(endpoints[0][c], endpoints[1][c], bc7Weights[index]));
+		}
+	}
+}
+
+void TextureCompressor::EncodeColorBlock(Block const& block, uint8_t* output)
+{
+	static constexpr std::array<float, 4> paletteWeights = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+	auto [endpoint0, endpoint1] = ComputeEndpoints(block, false);
+	auto best = EncodeColorEndpoints(block, endpoint0, endpoint1);
+
+	// kicsit befele huzott vegpontokkal az 5:6:5 kvantalas kevesbe rontja a kozbulso szineket
+	auto inset = (endpoint0 - endpoint1) / 16.0f;
+	auto insetCandidate = EncodeColorEndpoints(block, endpoint0 - inset, endpoint1 + inset);
+	if (insetCandidate.error < best.error) best = insetCandidate;
+
+	// a vegpontokat a kapott indexekhez illesztjuk, amig javul
+	for (int iteration = 0; iteration < refineIterationCount && best.error > 0 && best.color0 != best.color1; iteration++) {
+		std::array<float, 16> weights;
+		for (size_t texelIdx = 0; texelIdx < block.size(); texelIdx++) {
+			weights[texelIdx] = paletteWeights[best.indices[texelIdx]];
+		}
+
+		if (!SolveEndpoints(block, weights, endpoint0, endpoint1)) break;
+
+		auto candidate = EncodeColorEndpoints(block, endpoint0, endpoint1);
+		if (candidate.error >= best.error) break;
+		best = candidate;
+	}
+
+	uint32_t indexBits = 0;
+	for (size_t texelIdx = 0; texelIdx < block.size(); texelIdx++) {
+		indexBits |= best.indices[texelIdx] << (2 * texelIdx);
+	}
+
+	output[0] = static_cast<uint8_t>(best.color0 & 0xff);
+	output[1] = static_cast<uint8_t>(best.color0 >> 8);
+	output[2] = static_cast<uint8_t>(best.color1 & 0xff);
+	output[3] = static_cast<uint8_t>(best.color1 >> 8);
+	for (int i = 0; i < 4; i++) {
+		output[4 + i] = static_cast<uint8_t>(indexBits >> (8 * i));
+	}
+}
+
+void TextureCompressor::EncodeAlphaBlock(Block const& block, uint8_t* output)
+{
+	int alpha0 = 0, alpha1 = 255;
+	for (auto const& texel : block) {
+		alpha0 = std::max<int>(alpha0, texel.a);
+		alpha1 = std::min<int>(alpha1, texel.a);
+	}
+
+	// alpha0 > alpha1 eseten 8 interpolalt ertek, egyenloseg eseten minden index 0 marad
+	uint64_t indexBits = 0;
+	if (alpha0 != alpha1) {
+		auto palette = GetAlphaPalette(alpha0, alpha1);
+
+		for (size_t texelIdx = 0; texelIdx < block.size(); texelIdx++) {
+			auto bestDistance = std::numeric_limits<int>::max();
+			uint64_t bestIndex = 0;
+
+			for (uint64_t i = 0; i < 8; i++) {
+				auto distance = std::abs(palette[i] - block[texelIdx].a);
+				if (distance < bestDistance) {
+					bestDistance = distance;
+					bestIndex = i;
+				}
+			}
+
+			indexBits |= bestIndex << (3 * texelIdx);
+		}
+	}
+
+	output[0] = static_cast<uint8_t>(alpha0);
+	output[1] = static_cast<uint8_t>(alpha1);
+	for (int i = 0; i < 6; i++) {
+		output[2 + i] = static_cast<uint8_t>(indexBits >> (8 * i));
+	}
+}
+
+void TextureCompressor::DecodeColorBlock(uint8_t const* input, Block& block, bool isAlwaysFourColor)
+{
+	auto color0 = static_cast<uint16_t>(input[0] | (input[1] << 8));
+	auto color1 = static_cast<uint16_t>(input[2] | (input[3] << 8));
+	auto indexBits = static_cast<uint32_t>(input[4] | (input[5] << 8) | (input[6] << 16) | (static_cast<uint32_t>(input[7]) << 24));
+
+	auto palette = GetColorPalette(color0, color1, isAlwaysFourColor || color0 > color1);
+
+	for (size_t texelIdx = 0; texelIdx < block.size(); texelIdx++) {
+		block[texelIdx] = glm::u8vec4(palette[(indexBits >> (2 * texelIdx)) & 3u]);
+	}
+}
+
+void TextureCompressor::DecodeAlphaBlock(uint8_t const* input, Block& block)
+{
+	auto palette = GetAlphaPalette(input[0], input[1]);
+
+	uint64_t indexBits = 0;
+	for (int i = 0; i < 6; i++) {
+		indexBits |= static_cast<uint64_t>(input[2 + i]) << (8 * i);
+	}
+
+	for (size_t texelIdx = 0; texelIdx < block.size(); texelIdx++) {
+		block[texelIdx].a = static_cast<uint8_t>(palette[(indexBits >> (3 * texelIdx)) & 7u]);
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "pch.h"
+
+#include "image_cache.h"
+
+// 4x4 texel block compressed formats, all of them decode to RGBA8
+enum class BlockFormat
+{
+	BC1,	// 8 bytes per block, RGB 5:6:5 endpoints, opaque
+	BC3,	// 16 bytes per block, BC1 color + 8 bit interpolated alpha
+	BC7		// 16 bytes per block, mode 6 only: RGBA 7:7:7:7 endpoints with p-bits, 4 bit indices
+};
+
+struct CompressedLevel
+{
+	glm::ivec2 size;
+	std::vector<uint8_t> data;
+};
+
+struct CompressedTexture
+{
+	BlockFormat format;
+	std::vector<CompressedLevel> levels;
+
+	size_t GetSizeBytes() const;
+};
+
+struct TextureCompressor
+{
+	static constexpr int blockDimension = 4;
+
+	using Block = std::array<glm::u8vec4, blockDimension * blockDimension>;
+
+	// "rgba8" means no compression, unknown names throw
+	static std::optional<BlockFormat> ParseFormat(std::string const& name);
+	static std::string GetFormatName(BlockFormat format);
+	static size_t GetBlockSize(BlockFormat format);
+	static size_t GetLevelSize(BlockFormat format, glm::ivec2 size);
+
+	// Full mip chain, the block rows are encoded on the thread pool
+	static CompressedTexture Compress(Image const& image, BlockFormat format);
+	static CompressedLevel CompressLevel(MipLevel const& level, BlockFormat format);
+	static MipLevel DecompressLevel(CompressedLevel const& level, BlockFormat format);
+	// Peak signal to noise ratio of the decoded level against the source in dB, for checking the encoder
+	static double ComputePsnr(MipLevel const& source, CompressedLevel const& level, BlockFormat format);
+
+	static void EncodeBc1(Block const& block, uint8_t* output);
+	static void EncodeBc3(Block const& block, uint8_t* output);
+	static void EncodeBc7(Block const& block, uint8_t* output);
+
+	// Reference decoders, the BC7 one only understands mode 6
+	static void DecodeBc1(uint8_t const* input, Block& block);
+	static void DecodeBc3(uint8_t const* input, Block& block);
+	static void DecodeBc7(uint8_t const* input, Block& block);
+
+private:
+	static void EncodeColorBlock(Block const& block, uint8_t* output);
+	static void EncodeAlphaBlock(Block const& block, uint8_t* output);
+	static void DecodeColorBlock(uint8_t const* input, Block& block, bool isAlwaysFourColor);
+	static void DecodeAlphaBlock(uint8_t const* input, Block& block);
+};
@@ -0,0 +1,227 @@
+#include "texture_packer.h"
+
+#include "load_report.h"
+#include "mip_generator.h"
+
+static constexpr std::array<BlockFace, BlockTextureSet::faceCount> allFaces = {
+	BlockFace::TOP, BlockFace::BOTTOM, BlockFace::NORTH, BlockFace::SOUTH, BlockFace::EAST, BlockFace::WEST
+};
+
+uint32_t BlockTextureSet::GetLevelCount() const
+{
+	return layers.empty() ? 0 : static_cast<uint32_t>(layers[0].size());
+}
+
+size_t BlockTextureSet::GetSizeBytes() const
+{
+	size_t sizeBytes = 0;
+	for (auto const& layer : layers) {
+		for (auto const& level : layer) {
+			sizeBytes += level.pixels.size();
+		}
+	}
+
+	return sizeBytes;
+}
+
+std::optional<uint32_t> BlockTextureSet::FindBlock(std::string const& blockName) const
+{
+	auto it = std::lower_bound(blockNames.begin(), blockNames.end(), blockName);
+	if (it == blockNames.end() || *it != blockName) return std::nullopt;
+
+	return static_cast<uint32_t>(it - blockNames.begin());
+}
+
+PackedTile const& BlockTextureSet::GetTile(uint32_t blockId, BlockFace face) const
+{
+	return tiles[blockFaces[blockId][static_cast<size_t>(face)]];
+}
+
+std::string BlockTextureSet::GetFaceName(BlockFace face)
+{
+	switch (face) {
+	case BlockFace::TOP: return "top";
+	case BlockFace::BOTTOM: return "bottom";
+	case BlockFace::NORTH: return "north";
+	case BlockFace::SOUTH: return "south";
+	case BlockFace::EAST: return "east";
+	case BlockFace::WEST: return "west";
+	}
+
+	throw std::runtime_error("unknown block face");
+}
+
+BlockTextureSet::Layout TexturePacker::ParseLayout(std::string const& name)
+{
+	if (name == "array") return BlockTextureSet::Layout::ARRAY;
+	if (name == "atlas") return BlockTextureSet::Layout::ATLAS;
+
+	throw std::runtime_error("unknown block texture layout: " + name);
+}
+
+BlockTextureSet TexturePacker::Pack(fs::path const& directory, BlockTextureSet::Layout layout)
+{
+	auto assetName = directory.filename().string();
+	LoadReport::ScopedPhase phase(assetName, "pack");
+
+	// a fajlnev szerinti sorrend miatt a tile-ok es a block id-k futasrol futasra ugyanazok
+	std::vector<fs::path> texturePaths;
+	for (auto const& entry : fs::directory_iterator(directory)) {
+		if (entry.is_regular_file() && entry.path().extension() == ".png") {
+			texturePaths.push_back(entry.path());
+		}
+	}
+	std::sort(texturePaths.begin(), texturePaths.end());
+
+	if (texturePaths.empty()) throw std::runtime_error("no block textures in " + directory.string());
+
+	std::vector<std::string> paths;
+	std::vector<std::string> tileNames;
+	for (auto const& texturePath : texturePaths) {
+		paths.push_back(texturePath.string());
+		tileNames.push_back(texturePath.stem().string());
+	}
+
+	auto images = theImageCache.LoadMany(paths);
+
+	BlockTextureSet textureSet;
+	textureSet.layout = layout;
+	textureSet.tileSize = images[0]->imageSize;
+
+	for (auto const& image : images) {
+		if (image->imageSize != textureSet.tileSize) throw std::runtime_error("block textures must have the same size: " + image->path);
+	}
+
+	if (layout == BlockTextureSet::Layout::ARRAY) {
+		PackArray(textureSet, images);
+	}
+	else {
+		PackAtlas(textureSet, images);
+	}
+
+	for (uint32_t tileIdx = 0; tileIdx < tileNames.size(); tileIdx++) {
+		textureSet.tileLookup.emplace(tileNames[tileIdx], tileIdx);
+	}
+
+	BuildBlockFaces(textureSet, tileNames);
+
+	theLoadReport.AddCounter(assetName, "tileCount", textureSet.tiles.size());
+	theLoadReport.AddCounter(assetName, "blockCount", textureSet.blockNames.size());
+	theLoadReport.AddCounter(assetName, "textureBytes", textureSet.GetSizeBytes());
+
+	theLogger.LogInfo("Packed {} block textures ({} blocks) into a {} of {}x{}, {} levels",
+		textureSet.tiles.size(), textureSet.blockNames.size(), layout == BlockTextureSet::Layout::ARRAY ? "texture array" : "atlas",
+		textureSet.size.x, textureSet.size.y, textureSet.GetLevelCount());
+
+	return textureSet;
+}
+
+void TexturePacker::PackArray(BlockTextureSet& textureSet, std::vector<ImageHandle> const& images)
+{
+	textureSet.size = textureSet.tileSize;
+
+	// a dekodolaskor elkeszult mip lanc retegenkent atkerul, a tomb minden retege RGBA
+	for (uint32_t layerIdx = 0; layerIdx < images.size(); layerIdx++) {
+		auto const& image = images[layerIdx];
+
+		auto& layer = textureSet.layers.emplace_back();
+		for (uint32_t levelIdx = 0; levelIdx < image->GetLevelCount(); levelIdx++) {
+			layer.push_back(MipLevel{ image->GetLevelSize(levelIdx), image->GetLevelRgba(levelIdx) });
+		}
+
+		textureSet.tiles.push_back(PackedTile{ layerIdx, glm::vec2(0.0f), glm::vec2(1.0f) });
+	}
+}
+
+void TexturePacker::PackAtlas(BlockTextureSet& textureSet, std::vector<ImageHandle> const& images)
+{
+	auto tileSize = textureSet.tileSize;
+	auto isPowerOfTwo = [](int value) { return value > 0 && (value & (value - 1)) == 0; };
+	if (!isPowerOfTwo(tileSize.x) || !isPowerOfTwo(tileSize.y)) throw std::runtime_error("atlas tiles must be power of two sized");
+
+	// a cella a tile ketszerese, igy egy cella minden szinten egesz texel-ekre esik, amig 1x1 nem lesz
+	auto border = tileSize / 2;
+	auto cellSize = tileSize + 2 * border;
+
+	auto tileCount = static_cast<int>(images.size());
+	auto columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(tileCount))));
+	auto rows = (tileCount + columns - 1) / columns;
+
+	MipLevel atlas;
+	atlas.size = glm::ivec2(columns, rows) * cellSize;
+	atlas.pixels.resize(size_t{ 4 } * atlas.size.x * atlas.size.y);
+
+	for (int tileIdx = 0; tileIdx < tileCount; tileIdx++) {
+		auto tilePixels = images[tileIdx]->GetLevelRgba(0);
+		auto cellOrigin = glm::ivec2(tileIdx % columns, tileIdx / columns) * cellSize;
+
+		// a keret a tile ismetlese, igy a szurt szelek ugyanugy illeszkednek, mint GL_REPEAT mellett
+		for (int y = 0; y < cellSize.y; y++) {
+			auto sourceY = ((y - border.y) % tileSize.y + tileSize.y) % tileSize.y;
+			for (int x = 0; x < cellSize.x; x++) {
+				auto sourceX = ((x - border.x) % tileSize.x + tileSize.x) % tileSize.x;
+
+				auto source = tilePixels.data() + 4 * (static_cast<size_t>(sourceY) * tileSize.x + sourceX);
+				auto target = atlas.pixels.data() + 4 * (static_cast<size_t>(cellOrigin.y + y) * atlas.size.x + cellOrigin.x + x);
+				std::memcpy(target, source, 4);
+			}
+		}
+
+		auto atlasSize = glm::vec2(atlas.size);
+		textureSet.tiles.push_back(PackedTile{ 0, glm::vec2(cellOrigin + border) / atlasSize, glm::vec2(cellOrigin + border + tileSize) / atlasSize });
+	}
+
+	// a cellanal kisebb szinteken mar a szomszedok is keverednenek
+	auto levelCount = MipGenerator::GetMipCount(cellSize);
+	auto mipLevels = MipGenerator::Generate(atlas.size, atlas.pixels.data(), PixelFormat::RGBA8);
+	mipLevels.resize(std::min<size_t>(mipLevels.size(), levelCount - 1));
+
+	textureSet.size = atlas.size;
+
+	auto& layer = textureSet.layers.emplace_back();
+	layer.push_back(std::move(atlas));
+	layer.insert(layer.end(), std::make_move_iterator(mipLevels.begin()), std::make_move_iterator(mipLevels.end()));
+}
+
+void TexturePacker::BuildBlockFaces(BlockTextureSet& textureSet, std::vector<std::string> const& tileNames)
+{
+	static std::array<std::string, 7> const faceSuffixes = { "_top", "_bottom", "_north", "_south", "_east", "_west", "_side" };
+
+	// a blokk neve a tile neve a lap utotag nelkul, az elso ilyen tile a vegso tartalek
+	std::map<std::string, uint32_t> firstTiles;
+	for (uint32_t tileIdx = 0; tileIdx < tileNames.size(); tileIdx++) {
+		auto blockName = tileNames[tileIdx];
+		for (auto const& suffix : faceSuffixes) {
+			if (blockName.size() > suffix.size() && blockName.ends_with(suffix)) {
+				blockName.resize(blockName.size() - suffix.size());
+				break;
+			}
+		}
+
+		firstTiles.emplace(blockName, tileIdx);
+	}
+
+	auto findTile = [&](std::string const& name) -> std::optional<uint32_t> {
+		auto it = textureSet.tileLookup.find(name);
+		if (it == textureSet.tileLookup.end()) return std::nullopt;
+		return it->second;
+	};
+
+	for (auto const& [blockName, firstTile] : firstTiles) {
+		std::array<uint32_t, BlockTextureSet::faceCount> faces;
+
+		for (auto face : allFaces) {
+			auto isSideFace = face != BlockFace::TOP && face != BlockFace::BOTTOM;
+
+			auto tile = findTile(blockName + "_" + BlockTextureSet::GetFaceName(face));
+			if (!tile && isSideFace) tile = findTile(blockName + "_side");
+			if (!tile && face == BlockFace::BOTTOM) tile = findTile(blockName + "_top");
+			if (!tile) tile = findTile(blockName);
+
+			faces[static_cast<size_t>(face)] = tile.value_or(firstTile);
+		}
+
+		textureSet.blockNames.push_back(blockName);
+		textureSet.blockFaces.push_back(faces);
+	}
+}
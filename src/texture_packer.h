@@ -0,0 +1,60 @@
+#pragma once
+#include "pch.h"
+
+#include "image_cache.h"
+
+enum struct BlockFace { TOP, BOTTOM, NORTH, SOUTH, EAST, WEST };
+
+// Where one tile ended up: a layer of the array, or a rect of the atlas (always layer 0)
+struct PackedTile
+{
+	uint32_t layer;
+	glm::vec2 uvMin;
+	glm::vec2 uvMax;
+};
+
+// A directory of block textures packed into one texture, a whole chunk can sample it with one binding
+struct BlockTextureSet
+{
+	static constexpr size_t faceCount = 6;
+
+	enum struct Layout { ARRAY, ATLAS } layout;
+
+	// The size of layer 0, the tile size for the array and the whole atlas otherwise
+	glm::ivec2 size;
+	glm::ivec2 tileSize;
+	// Every layer has the full mip chain starting with level 0, the atlas has a single layer
+	std::vector<std::vector<MipLevel>> layers;
+
+	// One tile per texture file, named by the file stem
+	std::vector<PackedTile> tiles;
+	std::unordered_map<std::string, uint32_t> tileLookup;
+
+	// The block id is the index, every face points into tiles
+	std::vector<std::string> blockNames;
+	std::vector<std::array<uint32_t, faceCount>> blockFaces;
+
+	uint32_t GetLevelCount() const;
+	size_t GetSizeBytes() const;
+
+	std::optional<uint32_t> FindBlock(std::string const& blockName) const;
+	PackedTile const& GetTile(uint32_t blockId, BlockFace face) const;
+
+	static std::string GetFaceName(BlockFace face);
+};
+
+struct TexturePacker
+{
+	// "array" or "atlas"
+	static BlockTextureSet::Layout ParseLayout(std::string const& name);
+
+	// Loads every png of the directory through the image cache, the tiles have to be the same size
+	static BlockTextureSet Pack(fs::path const& directory, BlockTextureSet::Layout layout);
+
+private:
+	static void PackArray(BlockTextureSet& textureSet, std::vector<ImageHandle> const& images);
+	// Every tile sits in a power of two cell with a wrapped border, so the box filtered levels never mix neighbours
+	static void PackAtlas(BlockTextureSet& textureSet, std::vector<ImageHandle> const& images);
+	// <block>_<face>, then <block>_side for the side faces, then <block>
+	static void BuildBlockFaces(BlockTextureSet& textureSet, std::vector<std::string> const& tileNames);
+};
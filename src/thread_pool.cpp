@@ -0,0 +1,116 @@
+#include "thread_pool.h"
+
+ThreadPool& ThreadPool::Instance()
+{
+	static ThreadPool instance;
+	return instance;
+}
+
+ThreadPool::ThreadPool() :
+	stopping{ false }
+{
+	// a hivo szal is dolgozik (ParallelFor), ezert eggyel kevesebb worker kell
+	auto hardwareThreads = std::thread::hardware_concurrency();
+	auto workerCount = std::max(1u, hardwareThreads > 1 ? hardwareThreads - 1 : 1u);
+
+	for (unsigned i = 0; i < workerCount; i++) {
+		workers.emplace_back([this]() { WorkerLoop(); });
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+
+	condition.notify_all();
+
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+void ThreadPool::ParallelFor(size_t count, std::function<void(size_t)> const& body)
+{
+	if (count == 0) return;
+
+	struct SharedState
+	{
+		std::atomic<size_t> nextIndex{ 0 };
+		size_t finishedCount = 0;
+		std::exception_ptr exception;
+		std::mutex mutex;
+		std::condition_variable finished;
+	};
+
+	auto state = std::make_shared<SharedState>();
+
+	// a body csak addig ervenyes, amig a hivo var, ezert csak egy sikeresen lefoglalt index utan szabad hozzanyulni
+	auto runIndices = [state, count, &body]() {
+		size_t index;
+		while ((index = state->nextIndex.fetch_add(1)) < count) {
+			try {
+				body(index);
+			}
+			catch (...) {
+				std::lock_guard<std::mutex> lock(state->mutex);
+				if (!state->exception) state->exception = std::current_exception();
+			}
+
+			std::lock_guard<std::mutex> lock(state->mutex);
+			if (++state->finishedCount == count) {
+				state->finished.notify_all();
+			}
+		}
+	};
+
+	auto helperCount = std::min(workers.size(), count - 1);
+	for (size_t i = 0; i < helperCount; i++) {
+		Enqueue(runIndices);
+	}
+
+	runIndices();
+
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->finished.wait(lock, [&state, count]() { return state->finishedCount == count; });
+
+	if (state->exception) {
+		std::rethrow_exception(state->exception);
+	}
+}
+
+size_t ThreadPool::GetWorkerCount() const
+{
+	return workers.size();
+}
+
+void ThreadPool::Enqueue(std::function<void()> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.push_back(std::move(job));
+	}
+
+	condition.notify_one();
+}
+
+void ThreadPool::WorkerLoop()
+{
+	while (true) {
+		std::function<void()> job;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [this]() { return stopping || !jobs.empty(); });
+
+			if (stopping && jobs.empty()) return;
+
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+
+		job();
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "pch.h"
+
+struct ThreadPool
+{
+	static ThreadPool& Instance();
+
+	ThreadPool();
+	~ThreadPool();
+
+	ThreadPool(ThreadPool const&) = delete;
+	ThreadPool& operator=(ThreadPool const&) = delete;
+	ThreadPool(ThreadPool&&) = delete;
+	ThreadPool& operator=(ThreadPool&&) = delete;
+
+	template<typename Func>
+	auto Submit(Func&& func) -> std::future<std::invoke_result_t<Func>>;
+
+	// Runs body(0..count-1) on the workers; the calling thread takes part too, so nesting it inside a job cannot deadlock
+	void ParallelFor(size_t count, std::function<void(size_t)> const& body);
+
+	size_t GetWorkerCount() const;
+
+private:
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> jobs;
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool stopping;
+
+	void Enqueue(std::function<void()> job);
+	void WorkerLoop();
+};
+
+inline ThreadPool& theThreadPool = ThreadPool::Instance();
+
+template<typename Func>
+auto ThreadPool::Submit(Func&& func) -> std::future<std::invoke_result_t<Func>>
+{
+	using Result = std::invoke_result_t<Func>;
+
+	// a packaged_task nem masolhato, a std::function viszont azt var
+	auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+	auto future = task->get_future();
+
+	Enqueue([task]() { (*task)(); });
+
+	return future;
+}
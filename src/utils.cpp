@@ -33,6 +33,20 @@ std::string Utils::ReadTextFile(std::string const& fileName)
 	return buffer.str();
 }
 
+uint64_t Utils::HashBytes(void const* data, size_t size, uint64_t seed)
+{
+	// FNV-1a, a seed-del lehet tobb buffert egymas utan hash-elni
+	auto bytes = static_cast<unsigned char const*>(data);
+	auto hash = seed;
+
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull;
+	}
+
+	return hash;
+}
+
 void Utils::GLFWwindowDeleter::operator()(GLFWwindow* ptr)
 {
 	if (ptr) {
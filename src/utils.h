@@ -4,6 +4,7 @@ struct Utils
 {
 	static std::vector<char> ReadBinaryFile(std::string const& fileName);
 	static std::string ReadTextFile(std::string const& fileName);
+	static uint64_t HashBytes(void const* data, size_t size, uint64_t seed = 0xcbf29ce484222325ull);
 
 	struct GLFWwindowDeleter
 	{
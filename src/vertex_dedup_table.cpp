@@ -0,0 +1,94 @@
+#include "vertex_dedup_table.h"
+
+static size_t NextPowerOfTwo(size_t value)
+{
+	size_t result = 16;
+	while (result < value) result <<= 1;
+	return result;
+}
+
+VertexDedupTable::VertexDedupTable(size_t expectedUniqueCount) :
+	count{ 0 }
+{
+	// kb. 50%-os toltottseggel indulunk, 70% folott duplazodik
+	slots.resize(NextPowerOfTwo(expectedUniqueCount * 2), Slot{ 0, emptyIndex });
+	mask = slots.size() - 1;
+}
+
+uint64_t VertexDedupTable::Hash(Vertex const& vertex)
+{
+	// A glm::vec3 a GLM_FORCE_DEFAULT_ALIGNED_GENTYPES miatt 16 byte, a negyedik float
+	// tartalma nem definialt, ezert csak a 8 hasznos komponenst hash-eljuk.
+	// A + 0.0f a -0.0f-bol +0.0f-t csinal, mert az operator== szerint a ketto egyenlo.
+	std::array<float, 8> components = {
+		vertex.pos.x + 0.0f, vertex.pos.y + 0.0f, vertex.pos.z + 0.0f,
+		vertex.color.x + 0.0f, vertex.color.y + 0.0f, vertex.color.z + 0.0f,
+		vertex.texCoord.x + 0.0f, vertex.texCoord.y + 0.0f
+	};
+
+	std::array<uint64_t, 4> words;
+	std::memcpy(words.data(), components.data(), sizeof(components));
+
+	uint64_t hash = 0x9e3779b97f4a7c15ull;
+	for (auto word : words) {
+		hash ^= word;
+		hash *= 0xff51afd7ed558ccdull;
+		hash ^= hash >> 32;
+	}
+
+	// murmur3 fmix64 a vegen, hogy az also bitek (slot index) es a felso bitek (tag) is jol keveredjenek
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ull;
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+uint32_t VertexDedupTable::InsertOrGet(Vertex const& vertex, std::vector<Vertex>& vertices)
+{
+	auto hash = Hash(vertex);
+	auto hashTag = static_cast<uint32_t>(hash >> 32);
+
+	for (auto slotIdx = static_cast<size_t>(hash) & mask;; slotIdx = (slotIdx + 1) & mask) {
+		auto& slot = slots[slotIdx];
+
+		if (slot.index == emptyIndex) {
+			auto newIndex = static_cast<uint32_t>(vertices.size());
+			vertices.push_back(vertex);
+			slot = Slot{ hashTag, newIndex };
+
+			if (++count * 10 > slots.size() * 7) {
+				Grow(vertices);
+			}
+
+			return newIndex;
+		}
+
+		if (slot.hashTag == hashTag && vertices[slot.index] == vertex) {
+			return slot.index;
+		}
+	}
+}
+
+size_t VertexDedupTable::Size() const
+{
+	return count;
+}
+
+void VertexDedupTable::Grow(std::vector<Vertex> const& vertices)
+{
+	std::vector<Slot> oldSlots(slots.size() * 2, Slot{ 0, emptyIndex });
+	std::swap(slots, oldSlots);
+	mask = slots.size() - 1;
+
+	for (auto const& oldSlot : oldSlots) {
+		if (oldSlot.index == emptyIndex) continue;
+
+		auto slotIdx = static_cast<size_t>(Hash(vertices[oldSlot.index])) & mask;
+		while (slots[slotIdx].index != emptyIndex) {
+			slotIdx = (slotIdx + 1) & mask;
+		}
+
+		slots[slotIdx] = oldSlot;
+	}
+}
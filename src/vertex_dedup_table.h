@@ -0,0 +1,34 @@
+#pragma once
+#include "pch.h"
+
+#include "model_loader.h"
+
+// Flat open addressing (linear probing) table for vertex deduplication.
+// It only stores indices into the output vertex array, so a slot is 8 bytes.
+struct VertexDedupTable
+{
+	VertexDedupTable(size_t expectedUniqueCount);
+
+	// Returns the index of an equal vertex in vertices, or appends the vertex and returns its new index
+	uint32_t InsertOrGet(Vertex const& vertex, std::vector<Vertex>& vertices);
+
+	size_t Size() const;
+
+	// Hash of the meaningful components only: the GLM_FORCE_DEFAULT_ALIGNED_GENTYPES padding is skipped
+	static uint64_t Hash(Vertex const& vertex);
+
+private:
+	static constexpr uint32_t emptyIndex = std::numeric_limits<uint32_t>::max();
+
+	struct Slot
+	{
+		uint32_t hashTag;
+		uint32_t index;
+	};
+
+	std::vector<Slot> slots;
+	size_t mask;
+	size_t count;
+
+	void Grow(std::vector<Vertex> const& vertices);
+};
@@ -0,0 +1,86 @@
+#include "vertex_packer.h"
+
+VertexQuantization::VertexQuantization() :
+	offset{ 0.0f, 0.0f, 0.0f },
+	scale{ 1.0f, 1.0f, 1.0f }
+{
+}
+
+VertexQuantization VertexPacker::ComputeQuantization(std::vector<Vertex> const& vertices)
+{
+	VertexQuantization quantization;
+	if (vertices.empty()) return quantization;
+
+	glm::vec3 boundsMin = vertices[0].pos;
+	glm::vec3 boundsMax = vertices[0].pos;
+	for (auto const& vertex : vertices) {
+		boundsMin = glm::min(boundsMin, vertex.pos);
+		boundsMax = glm::max(boundsMax, vertex.pos);
+	}
+
+	quantization.offset = boundsMin;
+	quantization.scale = boundsMax - boundsMin;
+
+	return quantization;
+}
+
+std::vector<PackedVertex> VertexPacker::Pack(std::vector<Vertex> const& vertices, VertexQuantization const& quantization)
+{
+	auto quantize = [](float value, float offset, float scale) -> uint16_t {
+		// lapos tengely menten (scale == 0) minden ertek az offset-re esik
+		if (scale <= 0.0f) return 0;
+
+		auto normalized = std::clamp((value - offset) / scale, 0.0f, 1.0f);
+		return static_cast<uint16_t>(std::lround(normalized * 65535.0f));
+	};
+
+	std::vector<PackedVertex> packedVertices;
+	packedVertices.reserve(vertices.size());
+
+	for (auto const& vertex : vertices) {
+		PackedVertex packedVertex;
+		packedVertex.pos = {
+			quantize(vertex.pos.x, quantization.offset.x, quantization.scale.x),
+			quantize(vertex.pos.y, quantization.offset.y, quantization.scale.y),
+			quantize(vertex.pos.z, quantization.offset.z, quantization.scale.z),
+			0
+		};
+		packedVertex.texCoord = {
+			glm::packHalf1x16(vertex.texCoord.x),
+			glm::packHalf1x16(vertex.texCoord.y)
+		};
+
+		packedVertices.push_back(packedVertex);
+	}
+
+	return packedVertices;
+}
+
+IndexType VertexPacker::SelectIndexType(size_t vertexCount)
+{
+	return vertexCount <= std::numeric_limits<uint16_t>::max() + size_t{ 1 } ? IndexType::UINT16 : IndexType::UINT32;
+}
+
+size_t VertexPacker::IndexSize(IndexType indexType)
+{
+	return indexType == IndexType::UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+std::vector<uint8_t> VertexPacker::PackIndices(std::vector<uint32_t> const& indices, IndexType indexType)
+{
+	std::vector<uint8_t> packedIndices(IndexSize(indexType) * indices.size());
+
+	if (indexType == IndexType::UINT32) {
+		std::memcpy(packedIndices.data(), indices.data(), packedIndices.size());
+		return packedIndices;
+	}
+
+	for (size_t i = 0; i < indices.size(); i++) {
+		if (indices[i] > std::numeric_limits<uint16_t>::max()) throw std::runtime_error("index does not fit into uint16");
+
+		auto index = static_cast<uint16_t>(indices[i]);
+		std::memcpy(packedIndices.data() + sizeof(uint16_t) * i, &index, sizeof(index));
+	}
+
+	return packedIndices;
+}
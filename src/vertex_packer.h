@@ -0,0 +1,34 @@
+#pragma once
+#include "pch.h"
+
+#include "model_loader.h"
+
+// Compact GPU vertex: 12 bytes instead of the 48 byte Vertex, the constant color is dropped
+struct PackedVertex
+{
+	std::array<uint16_t, 4> pos;		// unorm16 relative to the mesh bounds, w is padding
+	std::array<uint16_t, 2> texCoord;	// half float
+};
+
+static_assert(sizeof(PackedVertex) == 12, "PackedVertex must stay tightly packed");
+
+// Dequantization: position = offset + unorm * scale
+struct VertexQuantization
+{
+	glm::vec3 offset;
+	glm::vec3 scale;
+
+	VertexQuantization();
+};
+
+struct VertexPacker
+{
+	static VertexQuantization ComputeQuantization(std::vector<Vertex> const& vertices);
+	static std::vector<PackedVertex> Pack(std::vector<Vertex> const& vertices, VertexQuantization const& quantization);
+
+	// The narrowest index type that can address every vertex
+	static IndexType SelectIndexType(size_t vertexCount);
+	static size_t IndexSize(IndexType indexType);
+	// The indices in the GPU layout of indexType, ready for upload
+	static std::vector<uint8_t> PackIndices(std::vector<uint32_t> const& indices, IndexType indexType);
+};
@@ -2,6 +2,8 @@
 
 #include "../utils.h"
 #include "../runcfg.h"
+#include "../load_report.h"
+#include "../texture_cache.h"
 
 static VKAPI_ATTR VkBool32 VKAPI_CALL vkDebugCallback(
 	VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
@@ -22,6 +24,9 @@ VulkanContext::VulkanContext() :
 	presentQueue{ nullptr },
 	surface{ nullptr },
 	swapChain{ nullptr },
+	indexType{ IndexType::UINT32 },
+	isModelReady{ false },
+	textureFormat{ vk::Format::eR8G8B8A8Srgb },
 	dispatcher{ nullptr },
 	framebufferResized{ false },
 	msaaSamples{ vk::SampleCountFlagBits::e1 },
@@ -69,8 +74,6 @@ void VulkanContext::initVK()
 	createTextureImageView();
 	createTextureSampler();
 	loadModel();
-	createVertexBuffer();
-	createIndexBuffer();
 	createUniformBuffers();
 	createDescriptorPool();
 	createDescriptorSets();
@@ -93,6 +96,11 @@ void VulkanContext::initGlfwimVK()
 
 void VulkanContext::cleanupVK()
 {
+	// a worker meg hasznalhatja a betoltott adatokat, megvarjuk
+	if (pendingModel.valid()) {
+		pendingModel.wait();
+	}
+
 	cleanupSwapChain();
 
 	device.destroySampler(textureSampler);
@@ -143,6 +151,8 @@ void VulkanContext::drawFrameVK()
 		}
 	};
 
+	uploadPendingModel();
+
 	device.waitForFences(1, &inFlightFences[currentFrame], VK_TRUE, noTimeout);
 
 	vk::ResultValue<uint32_t> acquireRes{ vk::Result::eIncomplete, 0 };
@@ -444,6 +454,7 @@ void VulkanContext::createLogicalDevice()
 
 	vk::PhysicalDeviceFeatures deviceFeatures{};
 	deviceFeatures.samplerAnisotropy = VK_TRUE;
+	deviceFeatures.textureCompressionBC = physicalDevice.getFeatures().textureCompressionBC;
 
 	vk::DeviceCreateInfo createInfo{};
 	createInfo.pQueueCreateInfos = &queueCreateInfo;
@@ -608,16 +619,13 @@ void VulkanContext::createSwapChain()
 	cam.parameters.UpdateWindowSize((float)swapChainExtent.width, (float)swapChainExtent.height);
 }
 
-vk::ImageView VulkanContext::createImageView(vk::Image image, vk::Format format, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels)
+vk::ImageView VulkanContext::createImageView(vk::Image image, vk::Format format, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels, vk::ComponentMapping components)
 {
 	vk::ImageViewCreateInfo createInfo{};
 	createInfo.image = image;
 	createInfo.viewType = vk::ImageViewType::e2D;
 	createInfo.format = format;
-	createInfo.components.r = vk::ComponentSwizzle::eIdentity;
-	createInfo.components.g = vk::ComponentSwizzle::eIdentity;
-	createInfo.components.b = vk::ComponentSwizzle::eIdentity;
-	createInfo.components.a = vk::ComponentSwizzle::eIdentity;
+	createInfo.components = components;
 	createInfo.subresourceRange.aspectMask = aspectFlags;
 	createInfo.subresourceRange.baseMipLevel = 0;
 	createInfo.subresourceRange.levelCount = mipLevels;
@@ -902,46 +910,151 @@ void VulkanContext::createTextureImage()
 	//auto fileName = (theRuncfg.texturesDir / "viking_room" / "viking_room.png").string();
 	auto fileName = (theRuncfg.texturesDir / "dragon" / "textures" / "default_green.png").string();
 
-	int texWidth, texHeight, texChannels;
-	stbi_uc* pixels = stbi_load(fileName.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-	vk::DeviceSize imageSize = texWidth * texHeight * sizeof(uint32_t);
-	mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
+	// BC formatumok nelkul marad a tomoritetlen feltoltes
+	auto blockFormat = TextureCompressor::ParseFormat(theRuncfg.textureFormat);
+	if (blockFormat && physicalDevice.getFeatures().textureCompressionBC) {
+		createCompressedTextureImage(fileName, *blockFormat);
+		return;
+	}
 
-	if (!pixels) {
-		throw std::runtime_error("failed to load texture image!");
+	// a handle a fuggveny vegen elengedi a pixeleket, a staging buffer-be masolas utan mar nem kellenek
+	auto image = theImageCache.Load(fileName);
+	auto texWidth = static_cast<uint32_t>(image->imageSize.x);
+	auto texHeight = static_cast<uint32_t>(image->imageSize.y);
+	mipLevels = image->GetLevelCount();
+
+	// a kep a sajat formatumaban kerul fel, ha az eszkoz mintavetelezni tudja, kulonben RGBA-ra bovul
+	auto nativeFormat = findNativeTextureFormat(image->format);
+	auto uploadFormat = nativeFormat ? image->format : PixelFormat::RGBA8;
+	auto uploadChannelCount = static_cast<size_t>(PixelConverter::GetChannelCount(uploadFormat));
+	textureFormat = nativeFormat.value_or(vk::Format::eR8G8B8A8Srgb);
+
+	// a shader tovabbra is RGBA-t lat: a szurke a szin csatornakba, a hianyzo alpha 1-re
+	textureComponents = vk::ComponentMapping{};
+	if (uploadFormat == PixelFormat::R8 || uploadFormat == PixelFormat::RG8) {
+		auto alphaSource = uploadFormat == PixelFormat::RG8 ? vk::ComponentSwizzle::eG : vk::ComponentSwizzle::eOne;
+		textureComponents = vk::ComponentMapping{ vk::ComponentSwizzle::eR, vk::ComponentSwizzle::eR, vk::ComponentSwizzle::eR, alphaSource };
 	}
 
-	// staging buffer
+	vk::DeviceSize imageSize = 0;
+	for (uint32_t levelIdx = 0; levelIdx < mipLevels; levelIdx++) {
+		auto levelSize = image->GetLevelSize(levelIdx);
+		imageSize += uploadChannelCount * levelSize.x * levelSize.y;
+	}
+
+	// staging buffer, a mip lanc szintjei egymas utan, minden offset a texel meret tobbszorose
 	vk::Buffer stagingBuffer;
 	vk::DeviceMemory stagingBufferMemory;
 	auto stagingUsage = vk::BufferUsageFlagBits::eTransferSrc;
 	auto stagingMemoryProps = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
 	createBuffer(imageSize, stagingUsage, stagingMemoryProps, stagingBuffer, stagingBufferMemory);
 
-	// map staging buffer to cpu, and fill it
-	auto dataPtr = device.mapMemory(stagingBufferMemory, 0, imageSize);
-	std::memcpy(dataPtr, pixels, static_cast<size_t>(imageSize));
-	device.unmapMemory(stagingBufferMemory);
+	std::vector<vk::BufferImageCopy> regions;
+	auto dataPtr = static_cast<uint8_t*>(device.mapMemory(stagingBufferMemory, 0, imageSize));
+	vk::DeviceSize bufferOffset = 0;
 
-	// free the stb image
-	stbi_image_free(pixels);
+	for (uint32_t levelIdx = 0; levelIdx < mipLevels; levelIdx++) {
+		auto levelSize = image->GetLevelSize(levelIdx);
+		auto texelCount = static_cast<size_t>(levelSize.x) * levelSize.y;
+
+		// a bovites kozvetlenul a staging buffer-be ir, nincs koztes masolat
+		if (uploadFormat == image->format) {
+			std::memcpy(dataPtr + bufferOffset, image->GetLevelPixels(levelIdx), image->GetLevelSizeBytes(levelIdx));
+		}
+		else {
+			PixelConverter::ExpandToRgba(image->GetLevelPixels(levelIdx), image->format, dataPtr + bufferOffset, texelCount);
+		}
 
-	auto textureUsage = vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
+		regions.push_back(createLevelCopyRegion(bufferOffset, levelIdx, levelSize));
+		bufferOffset += uploadChannelCount * texelCount;
+	}
+
+	device.unmapMemory(stagingBufferMemory);
+
+	// a lanc a CPU-n keszult el, nincs blit, minden szint egy atvitellel kerul fel
+	auto textureUsage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
 	auto textureMemoryProps = vk::MemoryPropertyFlagBits::eDeviceLocal;
-	createImage(texWidth, texHeight, mipLevels, vk::SampleCountFlagBits::e1, vk::Format::eR8G8B8A8Srgb, vk::ImageTiling::eOptimal, textureUsage, textureMemoryProps, textureImage, textureImageMemory);
+	createImage(texWidth, texHeight, mipLevels, vk::SampleCountFlagBits::e1, textureFormat, vk::ImageTiling::eOptimal, textureUsage, textureMemoryProps, textureImage, textureImageMemory);
 
-	transitionImageLayout(textureImage, vk::Format::eR8G8B8A8Srgb, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, mipLevels);
-	copyBufferToImage(stagingBuffer, textureImage, texWidth, texHeight);
+	transitionImageLayout(textureImage, textureFormat, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, mipLevels);
+	copyBufferToImage(stagingBuffer, textureImage, regions);
+	transitionImageLayout(textureImage, textureFormat, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal, mipLevels);
 
 	device.destroyBuffer(stagingBuffer);
 	device.freeMemory(stagingBufferMemory);
+}
+
+std::optional<vk::Format> VulkanContext::findNativeTextureFormat(PixelFormat format)
+{
+	vk::Format candidate;
+	switch (format) {
+	case PixelFormat::R8: candidate = vk::Format::eR8Srgb; break;
+	case PixelFormat::RG8: candidate = vk::Format::eR8G8Srgb; break;
+	case PixelFormat::RGBA8: return vk::Format::eR8G8B8A8Srgb;
+	// a 3 csatornas formatumok mintavetelezeset alig tamogatja eszkoz
+	default: return std::nullopt;
+	}
+
+	// az R8 es RG8 sRGB valtozata nem kotelezo
+	auto requiredFeatures = vk::FormatFeatureFlagBits::eSampledImage | vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+	auto features = physicalDevice.getFormatProperties(candidate).optimalTilingFeatures;
+	if ((features & requiredFeatures) != requiredFeatures) return std::nullopt;
 
-	generateMipmaps(textureImage, vk::Format::eR8G8B8A8Srgb, texWidth, texHeight, mipLevels);
+	return candidate;
+}
+
+void VulkanContext::createCompressedTextureImage(std::string const& fileName, BlockFormat format)
+{
+	auto compressedTexture = TextureCache::LoadOrCompress(fileName, format);
+	textureComponents = vk::ComponentMapping{};
+
+	switch (format) {
+	case BlockFormat::BC1: textureFormat = vk::Format::eBc1RgbaSrgbBlock; break;
+	case BlockFormat::BC3: textureFormat = vk::Format::eBc3SrgbBlock; break;
+	case BlockFormat::BC7: textureFormat = vk::Format::eBc7SrgbBlock; break;
+	}
+
+	auto const& baseLevel = compressedTexture->levels[0];
+	auto texWidth = static_cast<uint32_t>(baseLevel.size.x);
+	auto texHeight = static_cast<uint32_t>(baseLevel.size.y);
+	mipLevels = static_cast<uint32_t>(compressedTexture->levels.size());
+	vk::DeviceSize imageSize = compressedTexture->GetSizeBytes();
+
+	// staging buffer, a szintek egymas utan; a blokkmeretek miatt minden offset 8 vagy 16 tobbszorose
+	vk::Buffer stagingBuffer;
+	vk::DeviceMemory stagingBufferMemory;
+	auto stagingUsage = vk::BufferUsageFlagBits::eTransferSrc;
+	auto stagingMemoryProps = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+	createBuffer(imageSize, stagingUsage, stagingMemoryProps, stagingBuffer, stagingBufferMemory);
+
+	std::vector<vk::BufferImageCopy> regions;
+	auto dataPtr = static_cast<uint8_t*>(device.mapMemory(stagingBufferMemory, 0, imageSize));
+	vk::DeviceSize bufferOffset = 0;
+
+	for (uint32_t levelIdx = 0; levelIdx < mipLevels; levelIdx++) {
+		auto const& level = compressedTexture->levels[levelIdx];
+		std::memcpy(dataPtr + bufferOffset, level.data.data(), level.data.size());
+		regions.push_back(createLevelCopyRegion(bufferOffset, levelIdx, level.size));
+		bufferOffset += level.data.size();
+	}
+
+	device.unmapMemory(stagingBufferMemory);
+
+	auto textureUsage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
+	auto textureMemoryProps = vk::MemoryPropertyFlagBits::eDeviceLocal;
+	createImage(texWidth, texHeight, mipLevels, vk::SampleCountFlagBits::e1, textureFormat, vk::ImageTiling::eOptimal, textureUsage, textureMemoryProps, textureImage, textureImageMemory);
+
+	transitionImageLayout(textureImage, textureFormat, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, mipLevels);
+	copyBufferToImage(stagingBuffer, textureImage, regions);
+	transitionImageLayout(textureImage, textureFormat, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal, mipLevels);
+
+	device.destroyBuffer(stagingBuffer);
+	device.freeMemory(stagingBufferMemory);
 }
 
 void VulkanContext::createTextureImageView()
 {
-	textureImageView = createImageView(textureImage, vk::Format::eR8G8B8A8Srgb, vk::ImageAspectFlagBits::eColor, mipLevels);
+	textureImageView = createImageView(textureImage, textureFormat, vk::ImageAspectFlagBits::eColor, mipLevels, textureComponents);
 }
 
 void VulkanContext::createTextureSampler()
@@ -1025,7 +1138,7 @@ LoadedModel VulkanContext::loadVikingRoom()
 	return modelLoader.Load(modelFileName, mtlDirectory, ModelLoader::LoadSettings{});
 }
 
-LoadedModel VulkanContext::LoadDragon()
+std::future<LoadedModel> VulkanContext::LoadDragon()
 {
 	auto baseDir = theRuncfg.texturesDir / "dragon";
 	auto modelFileName = (baseDir / "dragon.obj").string();
@@ -1033,25 +1146,73 @@ LoadedModel VulkanContext::LoadDragon()
 
 	ModelLoader::LoadSettings loadSettings;
 	loadSettings.ignoreMissingUVs = true;
+	loadSettings.optimizeVertexCache = true;
+	loadSettings.optimizeOverdraw = true;
+	loadSettings.optimizeVertexFetch = true;
 
-	ModelLoader modelLoader;
-	return modelLoader.Load(modelFileName, mtlDirectory, loadSettings);
+	return ModelLoader::LoadAsync(modelFileName, mtlDirectory, loadSettings);
 }
 
 void VulkanContext::loadModel()
 {
-	auto loadedModel = LoadDragon();
+	// a betoltes a worker szalakon fut, addig ures jelenetet rajzolunk
+	pendingModel = LoadDragon();
+}
+
+void VulkanContext::uploadPendingModel()
+{
+	if (!pendingModel.valid() || pendingModel.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+
+	LoadedModel loadedModel;
+	try {
+		loadedModel = pendingModel.get();
+	}
+	catch (std::exception& e) {
+		theLogger.LogError("Model loading failed: {}", e.what());
+		theLoadReport.Write(theRuncfg.loadReportPath);
+		return;
+	}
 
 	// TODO only works with shape 0
-	auto const& shape = loadedModel.shapes[0];
+	auto& shape = loadedModel.shapes[0];
 
 	vertices = std::move(shape.vertices);
 	indices = std::move(shape.indices);
+	indexType = shape.indexType;
+
+	// a regi command buffer-ek meg futhatnak, utana ujra kell rogziteni oket a rajzolassal
+	device.waitIdle();
+
+	{
+		// a staging masolas megvarja a queue-t, igy ez a tenyleges feltoltesi ido
+		LoadReport::ScopedPhase phase(loadedModel.name, "gpuUpload");
+		createVertexBuffer();
+		createIndexBuffer();
+	}
+	isModelReady = true;
+
+	auto vertexBytes = getVertexBindingDescription().stride * vertices.size();
+	auto indexBytes = VertexPacker::IndexSize(indexType) * indices.size();
+	theLoadReport.AddCounter(loadedModel.name, "gpuBytes", vertexBytes + indexBytes);
+
+	device.freeCommandBuffers(commandPool, static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+	createCommandBuffers();
+
+	theLoadReport.Write(theRuncfg.loadReportPath);
+	theImageCache.LogStats();
 }
 
 void VulkanContext::createVertexBuffer()
 {
-	vk::DeviceSize bufferSize = sizeof(Vertex) * vertices.size();
+	// packed eseten 12 byte / vertex megy fel a 48 helyett
+	std::vector<PackedVertex> packedVertices;
+	if (theRuncfg.packedVertices) {
+		vertexQuantization = VertexPacker::ComputeQuantization(vertices);
+		packedVertices = VertexPacker::Pack(vertices, vertexQuantization);
+	}
+
+	auto vertexData = theRuncfg.packedVertices ? static_cast<void const*>(packedVertices.data()) : static_cast<void const*>(vertices.data());
+	vk::DeviceSize bufferSize = getVertexBindingDescription().stride * vertices.size();
 
 	// staging buffer
 	vk::Buffer stagingBuffer;
@@ -1062,7 +1223,7 @@ void VulkanContext::createVertexBuffer()
 
 	// map staging buffer to cpu, and fill it
 	auto dataPtr = device.mapMemory(stagingBufferMemory, 0, bufferSize);
-	std::memcpy(dataPtr, vertices.data(), static_cast<size_t>(bufferSize));
+	std::memcpy(dataPtr, vertexData, static_cast<size_t>(bufferSize));
 	device.unmapMemory(stagingBufferMemory);
 
 	// vertex buffer
@@ -1080,7 +1241,8 @@ void VulkanContext::createVertexBuffer()
 
 void VulkanContext::createIndexBuffer()
 {
-	vk::DeviceSize bufferSize = sizeof(uint32_t) * indices.size();
+	auto packedIndices = VertexPacker::PackIndices(indices, indexType);
+	vk::DeviceSize bufferSize = packedIndices.size();
 
 	// staging buffer
 	vk::Buffer stagingBuffer;
@@ -1091,7 +1253,7 @@ void VulkanContext::createIndexBuffer()
 
 	// map staging buffer to cpu, and fill it
 	auto dataPtr = device.mapMemory(stagingBufferMemory, 0, bufferSize);
-	std::memcpy(dataPtr, indices.data(), static_cast<size_t>(bufferSize));
+	std::memcpy(dataPtr, packedIndices.data(), static_cast<size_t>(bufferSize));
 	device.unmapMemory(stagingBufferMemory);
 
 	// index buffer
@@ -1195,92 +1357,6 @@ void VulkanContext::createColorResources()
 	colorImageView = createImageView(colorImage, colorFormat, vk::ImageAspectFlagBits::eColor, 1);
 }
 
-void VulkanContext::generateMipmaps(vk::Image image, vk::Format imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels)
-{
-	// Check if image format supports linear blitting
-	vk::FormatProperties formatProperties = physicalDevice.getFormatProperties(imageFormat);
-	if (!(formatProperties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImageFilterLinear)) {
-		throw std::runtime_error("texture image format does not support linear blitting!");
-	}
-
-	vk::CommandBuffer commandBuffer = beginSingleTimeCommands();
-
-	vk::ImageMemoryBarrier barrier{};
-	barrier.image = image;
-	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-	barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-	barrier.subresourceRange.baseArrayLayer = 0;
-	barrier.subresourceRange.layerCount = 1;
-	barrier.subresourceRange.levelCount = 1;
-
-	int32_t mipWidth = texWidth;
-	int32_t mipHeight = texHeight;
-
-	// loop start at i = 1
-	for (uint32_t i = 1; i < mipLevels; i++) {
-		barrier.subresourceRange.baseMipLevel = i - 1;
-		barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
-		barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
-		barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-		barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
-
-		commandBuffer.pipelineBarrier(
-			vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {},
-			0, nullptr,
-			0, nullptr,
-			1, &barrier);
-
-		vk::ImageBlit blit{};
-		blit.srcOffsets[0] = { 0, 0, 0 };
-		blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
-		blit.srcSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
-		blit.srcSubresource.mipLevel = i - 1;
-		blit.srcSubresource.baseArrayLayer = 0;
-		blit.srcSubresource.layerCount = 1;
-		blit.dstOffsets[0] = { 0, 0, 0 };
-		blit.dstOffsets[1] = { mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1 };
-		blit.dstSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
-		blit.dstSubresource.mipLevel = i;
-		blit.dstSubresource.baseArrayLayer = 0;
-		blit.dstSubresource.layerCount = 1;
-
-		commandBuffer.blitImage(
-			image, vk::ImageLayout::eTransferSrcOptimal,
-			image, vk::ImageLayout::eTransferDstOptimal,
-			1, &blit,
-			vk::Filter::eLinear);
-
-		barrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal;
-		barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-		barrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
-		barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-
-		commandBuffer.pipelineBarrier(
-			vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader, {},
-			0, nullptr,
-			0, nullptr,
-			1, &barrier);
-
-		if (mipWidth > 1) mipWidth /= 2;
-		if (mipHeight > 1) mipHeight /= 2;
-	}
-
-	barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-	barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
-	barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-	barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-	barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-
-	commandBuffer.pipelineBarrier(
-		vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader, {},
-		0, nullptr,
-		0, nullptr,
-		1, &barrier);
-
-	endSingleTimeCommands(commandBuffer);
-}
-
 vk::CommandBuffer VulkanContext::beginSingleTimeCommands()
 {
 	vk::CommandBufferAllocateInfo allocInfo{};
@@ -1326,24 +1402,29 @@ void VulkanContext::copyBuffer(vk::Buffer srcBuffer, vk::Buffer dstBuffer, vk::D
 	endSingleTimeCommands(commandBuffer);
 }
 
-void VulkanContext::copyBufferToImage(vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height)
+vk::BufferImageCopy VulkanContext::createLevelCopyRegion(vk::DeviceSize bufferOffset, uint32_t mipLevel, glm::ivec2 size)
 {
-	auto commandBuffer = beginSingleTimeCommands();
-
 	vk::BufferImageCopy region{};
-	region.bufferOffset = 0;
+	region.bufferOffset = bufferOffset;
 	region.bufferRowLength = 0;
 	region.bufferImageHeight = 0;
 
 	region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
-	region.imageSubresource.mipLevel = 0;
+	region.imageSubresource.mipLevel = mipLevel;
 	region.imageSubresource.baseArrayLayer = 0;
 	region.imageSubresource.layerCount = 1;
 
 	region.imageOffset = { 0, 0, 0 };
-	region.imageExtent = { width, height, 1 };
+	region.imageExtent = { static_cast<uint32_t>(size.x), static_cast<uint32_t>(size.y), 1 };
 
-	commandBuffer.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, 1, &region);
+	return region;
+}
+
+void VulkanContext::copyBufferToImage(vk::Buffer buffer, vk::Image image, std::vector<vk::BufferImageCopy> const& regions)
+{
+	auto commandBuffer = beginSingleTimeCommands();
+
+	commandBuffer.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, static_cast<uint32_t>(regions.size()), regions.data());
 
 	endSingleTimeCommands(commandBuffer);
 }
@@ -1420,13 +1501,17 @@ void VulkanContext::createCommandBuffers()
 		commandBuffers[i].beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
 		commandBuffers[i].bindPipeline(vk::PipelineBindPoint::eGraphics, graphicsPipeline);
 
-		vk::Buffer vertexBuffers[] = { vertexBuffer };
-		VkDeviceSize offsets[] = { 0 };
-		commandBuffers[i].bindVertexBuffers(0, 1, vertexBuffers, offsets);
-		commandBuffers[i].bindIndexBuffer(indexBuffer, 0, vk::IndexType::eUint32);
-		commandBuffers[i].bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipelineLayout, 0, 1, &descriptorSets[i], 0, nullptr);
+		// amig a modell nem toltodott be, csak a torles fut
+		if (isModelReady) {
+			vk::Buffer vertexBuffers[] = { vertexBuffer };
+			VkDeviceSize offsets[] = { 0 };
+			commandBuffers[i].bindVertexBuffers(0, 1, vertexBuffers, offsets);
+			auto vkIndexType = indexType == IndexType::UINT16 ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+			commandBuffers[i].bindIndexBuffer(indexBuffer, 0, vkIndexType);
+			commandBuffers[i].bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipelineLayout, 0, 1, &descriptorSets[i], 0, nullptr);
 
-		commandBuffers[i].drawIndexed(static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
+			commandBuffers[i].drawIndexed(static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
+		}
 
 		commandBuffers[i].endRenderPass();
 		commandBuffers[i].end();
@@ -1475,6 +1560,8 @@ void VulkanContext::updateUniformBuffer(uint32_t currentImage)
 	ubo.model = glm::rotate(identity, time * glm::radians(22.5f), glm::vec3(0.0f, 1.0f, 0.0f));
 	ubo.view = camera->V();
 	ubo.proj = camera->P();
+	ubo.posOffset = glm::vec4(vertexQuantization.offset, 0.0f);
+	ubo.posScale = glm::vec4(vertexQuantization.scale, 0.0f);
 
 	// map uniform buffer to cpu, and fill it
 	auto dataPtr = device.mapMemory(uniformBuffersMemory[currentImage], 0, sizeof(ubo));
@@ -1566,33 +1653,30 @@ vk::VertexInputBindingDescription VulkanContext::getVertexBindingDescription()
 {
 	vk::VertexInputBindingDescription bindingDescription{};
 	bindingDescription.binding = 0;
-	bindingDescription.stride = sizeof(Vertex);
+	bindingDescription.stride = theRuncfg.packedVertices ? sizeof(PackedVertex) : sizeof(Vertex);
 	bindingDescription.inputRate = vk::VertexInputRate::eVertex;
 
 	return bindingDescription;
 }
 
-std::array<vk::VertexInputAttributeDescription, 3> VulkanContext::getVertexAttributeDescriptions()
+std::array<vk::VertexInputAttributeDescription, 2> VulkanContext::getVertexAttributeDescriptions()
 {
-	std::array<vk::VertexInputAttributeDescription, 3> attributeDescriptions{};
+	std::array<vk::VertexInputAttributeDescription, 2> attributeDescriptions{};
+	auto packed = theRuncfg.packedVertices;
 
 	auto& posDesc = attributeDescriptions[0];
 	posDesc.binding = 0;
 	posDesc.location = 0;
-	posDesc.format = vk::Format::eR32G32B32Sfloat;
-	posDesc.offset = offsetof(Vertex, pos);
+	posDesc.format = packed ? vk::Format::eR16G16B16A16Unorm : vk::Format::eR32G32B32Sfloat;
+	posDesc.offset = packed ? offsetof(PackedVertex, pos) : offsetof(Vertex, pos);
 
-	auto& colorDesc = attributeDescriptions[1];
-	colorDesc.binding = 0;
-	colorDesc.location = 1;
-	colorDesc.format = vk::Format::eR32G32B32Sfloat;
-	colorDesc.offset = offsetof(Vertex, color);
+	// a szin konstans volt, a shader mar nem olvassa
 
-	auto& textCoordDesc = attributeDescriptions[2];
+	auto& textCoordDesc = attributeDescriptions[1];
 	textCoordDesc.binding = 0;
 	textCoordDesc.location = 2;
-	textCoordDesc.format = vk::Format::eR32G32Sfloat;
-	textCoordDesc.offset = offsetof(Vertex, texCoord);
+	textCoordDesc.format = packed ? vk::Format::eR16G16Sfloat : vk::Format::eR32G32Sfloat;
+	textCoordDesc.offset = packed ? offsetof(PackedVertex, texCoord) : offsetof(Vertex, texCoord);
 
 	return attributeDescriptions;
 }
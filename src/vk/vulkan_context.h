@@ -2,6 +2,7 @@
 
 #include "../camera.h"
 #include "../model_loader.h"
+#include "../vertex_packer.h"
 
 struct QueueFamilyIndices
 {
@@ -23,6 +24,8 @@ struct UniformBufferObject
 	alignas(16) glm::mat4 model;
 	alignas(16) glm::mat4 view;
 	alignas(16) glm::mat4 proj;
+	alignas(16) glm::vec4 posOffset;
+	alignas(16) glm::vec4 posScale;
 };
 
 struct VulkanContext
@@ -63,8 +66,14 @@ private:
 	std::vector<vk::Fence> inFlightFences, imagesInFlight;
 	std::vector<Vertex> vertices;
 	std::vector<uint32_t> indices;
+	IndexType indexType;
+	VertexQuantization vertexQuantization;
+	std::future<LoadedModel> pendingModel;
+	bool isModelReady;
 	vk::Buffer vertexBuffer, indexBuffer;
 	uint32_t mipLevels;
+	vk::Format textureFormat;
+	vk::ComponentMapping textureComponents;
 	vk::Image textureImage;
 	vk::DeviceMemory vertexBufferMemory, indexBufferMemory, textureImageMemory;
 	std::vector<vk::Buffer> uniformBuffers;
@@ -111,7 +120,7 @@ private:
 	void recreateSwapChain();
 	void cleanupSwapChain();
 	void createSwapChain();
-	vk::ImageView createImageView(vk::Image image, vk::Format format, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels);
+	vk::ImageView createImageView(vk::Image image, vk::Format format, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels, vk::ComponentMapping components = {});
 	void createImageViews();
 	void createRenderPass();
 	void createDescriptorSetLayout();
@@ -120,22 +129,25 @@ private:
 	void createCommandPool();
 	void createDepthResources();
 	void createTextureImage();
+	std::optional<vk::Format> findNativeTextureFormat(PixelFormat format);
+	void createCompressedTextureImage(std::string const& fileName, BlockFormat format);
 	void createTextureImageView();
 	void createTextureSampler();
 	void createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, vk::Buffer& buffer, vk::DeviceMemory& bufferMemory);
 	void createImage(uint32_t width, uint32_t height, uint32_t mipLevels, vk::SampleCountFlagBits numSamples, vk::Format format, vk::ImageTiling tiling, vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties, vk::Image& image, vk::DeviceMemory& imageMemory);
 	void loadModel();
+	void uploadPendingModel();
 	void createVertexBuffer();
 	void createIndexBuffer();
 	void createUniformBuffers();
 	void createDescriptorPool();
 	void createDescriptorSets();
 	void createColorResources();
-	void generateMipmaps(vk::Image image, vk::Format imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels);
 	vk::CommandBuffer beginSingleTimeCommands();
 	void endSingleTimeCommands(vk::CommandBuffer commandBuffer);
 	void copyBuffer(vk::Buffer srcBuffer, vk::Buffer dstBuffer, vk::DeviceSize size);
-	void copyBufferToImage(vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height);
+	vk::BufferImageCopy createLevelCopyRegion(vk::DeviceSize bufferOffset, uint32_t mipLevel, glm::ivec2 size);
+	void copyBufferToImage(vk::Buffer buffer, vk::Image image, std::vector<vk::BufferImageCopy> const& regions);
 	uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties);
 	vk::Format findSupportedFormat(const std::vector<vk::Format>& candidates, vk::ImageTiling tiling, vk::FormatFeatureFlags features);
 	vk::Format findDepthFormat();
@@ -147,8 +159,8 @@ private:
 	void transitionImageLayout(vk::Image image, vk::Format format, vk::ImageLayout oldLayout, vk::ImageLayout newLayout, uint32_t mipLevels);
 	vk::SampleCountFlagBits getMaxUsableSampleCount();
 	vk::VertexInputBindingDescription getVertexBindingDescription();
-	std::array<vk::VertexInputAttributeDescription, 3> getVertexAttributeDescriptions();
+	std::array<vk::VertexInputAttributeDescription, 2> getVertexAttributeDescriptions();
 
 	LoadedModel loadVikingRoom();
-	LoadedModel LoadDragon();
+	std::future<LoadedModel> LoadDragon();
 };
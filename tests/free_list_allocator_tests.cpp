@@ -0,0 +1,171 @@
+#include "test_registry.h"
+
+#include "../src/gl/geometry_arena.h"
+
+#include <random>
+
+TEST_CASE(FreeListAllocator, AllocateAndFree)
+{
+	FreeListAllocator allocator(100);
+	TEST_CHECK(allocator.GetCapacity() == 100);
+
+	TEST_CHECK(allocator.Allocate(10, 1) == size_t{ 0 });
+	TEST_CHECK(allocator.Allocate(20, 1) == size_t{ 10 });
+	TEST_CHECK(allocator.Allocate(30, 1) == size_t{ 30 });
+	TEST_CHECK(allocator.GetUsedBytes() == 60);
+	TEST_CHECK(allocator.GetFreeRangeCount() == 1);
+	TEST_CHECK(allocator.GetLargestFreeRange() == 40);
+
+	// a felszabaditott hely ujra kiadhato, first fit
+	allocator.Free(10, 20);
+	TEST_CHECK(allocator.GetUsedBytes() == 40);
+	TEST_CHECK(allocator.GetFreeRangeCount() == 2);
+	TEST_CHECK(allocator.Allocate(15, 1) == size_t{ 10 });
+
+	// a meret nelkuli foglalas nem fogyaszt es nem darabol
+	TEST_CHECK(allocator.Allocate(0, 16) == size_t{ 0 });
+	TEST_CHECK(allocator.GetUsedBytes() == 55);
+	TEST_CHECK(allocator.GetFreeRangeCount() == 2);
+}
+
+TEST_CASE(FreeListAllocator, MergeWithNext)
+{
+	FreeListAllocator allocator(100);
+	allocator.Allocate(10, 1);
+	allocator.Allocate(20, 1);
+	allocator.Allocate(30, 1);
+
+	// az utolso foglalas a vegen levo szabad tartomannyal olvad ossze
+	allocator.Free(30, 30);
+	TEST_CHECK(allocator.GetFreeRangeCount() == 1);
+	TEST_CHECK(allocator.GetLargestFreeRange() == 70);
+
+	allocator.Free(10, 20);
+	TEST_CHECK(allocator.GetFreeRangeCount() == 1);
+	TEST_CHECK(allocator.GetLargestFreeRange() == 90);
+}
+
+TEST_CASE(FreeListAllocator, MergeWithPrev)
+{
+	FreeListAllocator allocator(60);
+	allocator.Allocate(10, 1);
+	allocator.Allocate(20, 1);
+	allocator.Allocate(30, 1);
+	TEST_CHECK(allocator.GetFreeRangeCount() == 0);
+
+	allocator.Free(0, 10);
+	allocator.Free(10, 20);
+	TEST_CHECK(allocator.GetFreeRangeCount() == 1);
+	TEST_CHECK(allocator.GetLargestFreeRange() == 30);
+	TEST_CHECK(allocator.Allocate(30, 1) == size_t{ 0 });
+}
+
+TEST_CASE(FreeListAllocator, MergeWithBoth)
+{
+	FreeListAllocator allocator(60);
+	allocator.Allocate(10, 1);
+	allocator.Allocate(20, 1);
+	allocator.Allocate(30, 1);
+
+	allocator.Free(0, 10);
+	allocator.Free(30, 30);
+	TEST_CHECK(allocator.GetFreeRangeCount() == 2);
+
+	// a kozepso mindket szomszedjaval egy tartomannya valik
+	allocator.Free(10, 20);
+	TEST_CHECK(allocator.GetFreeRangeCount() == 1);
+	TEST_CHECK(allocator.GetLargestFreeRange() == 60);
+	TEST_CHECK(allocator.GetUsedBytes() == 0);
+}
+
+TEST_CASE(FreeListAllocator, NonPowerOfTwoAlignment)
+{
+	FreeListAllocator allocator(100);
+	TEST_CHECK(allocator.Allocate(5, 1) == size_t{ 0 });
+
+	// a 12-es igazitas elotti [5, 12) szabad marad
+	TEST_CHECK(allocator.Allocate(12, 12) == size_t{ 12 });
+	TEST_CHECK(allocator.GetFreeRangeCount() == 2);
+
+	// [5, 12)-ben a 3-mal oszthato 6-tol 7 byte nem fer el, a kovetkezo tartomany 24-en kezdodik
+	TEST_CHECK(allocator.Allocate(7, 3) == size_t{ 24 });
+	// 7-tol 4 byte meg befer a resbe, ket kis darabot hagyva
+	TEST_CHECK(allocator.Allocate(4, 7) == size_t{ 7 });
+	TEST_CHECK(allocator.GetFreeRangeCount() == 3);
+	TEST_CHECK(allocator.GetUsedBytes() == 28);
+
+	// vertex stride-ok: minden offset a stride tobbszorose
+	FreeListAllocator strided(1000);
+	for (size_t stride : { size_t{ 20 }, size_t{ 12 }, size_t{ 28 }, size_t{ 20 } }) {
+		auto offset = strided.Allocate(3 * stride, stride);
+		TEST_CHECK(offset.has_value());
+		TEST_CHECK(*offset % stride == 0);
+	}
+}
+
+TEST_CASE(FreeListAllocator, Exhaustion)
+{
+	FreeListAllocator allocator(64);
+	TEST_CHECK(allocator.Allocate(64, 1) == size_t{ 0 });
+	TEST_CHECK(!allocator.Allocate(1, 1).has_value());
+	TEST_CHECK(allocator.GetFreeRangeCount() == 0);
+
+	allocator.Free(0, 64);
+	TEST_CHECK(!allocator.Allocate(65, 1).has_value());
+	TEST_CHECK(allocator.GetUsedBytes() == 0);
+
+	// van 9 szabad byte, de az igazitas miatt nem egyben
+	FreeListAllocator aligned(10);
+	TEST_CHECK(aligned.Allocate(1, 1) == size_t{ 0 });
+	TEST_CHECK(!aligned.Allocate(9, 3).has_value());
+	TEST_CHECK(aligned.Allocate(7, 3) == size_t{ 3 });
+
+	FreeListAllocator empty(0);
+	TEST_CHECK(!empty.Allocate(1, 1).has_value());
+}
+
+TEST_CASE(FreeListAllocator, RandomizedConsistency)
+{
+	static constexpr size_t capacity = 1 << 16;
+
+	FreeListAllocator allocator(capacity);
+	std::map<size_t, size_t> allocations;
+	std::mt19937 random(42);
+
+	for (int step = 0; step < 20000; step++) {
+		if (allocations.empty() || random() % 3 != 0) {
+			auto size = 1 + random() % 700;
+			auto alignment = 1 + random() % 24;
+			auto offset = allocator.Allocate(size, alignment);
+			if (!offset) continue;
+
+			TEST_CHECK(*offset % alignment == 0);
+			TEST_CHECK(*offset + size <= capacity);
+
+			// nem fedhet at a szomszedaival
+			auto next = allocations.lower_bound(*offset);
+			TEST_CHECK(next == allocations.end() || *offset + size <= next->first);
+			TEST_CHECK(next == allocations.begin() || std::prev(next)->first + std::prev(next)->second <= *offset);
+
+			allocations.emplace(*offset, size);
+		}
+		else {
+			auto it = std::next(allocations.begin(), random() % allocations.size());
+			allocator.Free(it->first, it->second);
+			allocations.erase(it);
+		}
+
+		size_t usedBytes = 0;
+		for (auto const& [offset, size] : allocations) usedBytes += size;
+		TEST_CHECK(allocator.GetUsedBytes() == usedBytes);
+	}
+
+	// mindent felszabaditva egyetlen, teljes tartomany marad
+	for (auto const& [offset, size] : allocations) {
+		allocator.Free(offset, size);
+	}
+
+	TEST_CHECK(allocator.GetUsedBytes() == 0);
+	TEST_CHECK(allocator.GetFreeRangeCount() == 1);
+	TEST_CHECK(allocator.GetLargestFreeRange() == capacity);
+}
@@ -0,0 +1,222 @@
+#include "test_registry.h"
+
+#include "../src/meshlet_builder.h"
+
+using Triangle = std::array<uint32_t, 3>;
+
+// Regular grid of gridSize x gridSize quads in the z = 0 plane, every triangle faces +z
+static TinyObjShape MakeGrid(int gridSize)
+{
+	TinyObjShape shape{};
+
+	for (int y = 0; y <= gridSize; y++) {
+		for (int x = 0; x <= gridSize; x++) {
+			shape.vertices.push_back(Vertex{ { static_cast<float>(x), static_cast<float>(y), 0.0f }, { 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f } });
+		}
+	}
+
+	auto vertexIdx = [gridSize](int x, int y) { return static_cast<uint32_t>(y * (gridSize + 1) + x); };
+	for (int y = 0; y < gridSize; y++) {
+		for (int x = 0; x < gridSize; x++) {
+			shape.indices.insert(shape.indices.end(), { vertexIdx(x, y), vertexIdx(x + 1, y), vertexIdx(x + 1, y + 1) });
+			shape.indices.insert(shape.indices.end(), { vertexIdx(x, y), vertexIdx(x + 1, y + 1), vertexIdx(x, y + 1) });
+		}
+	}
+
+	return shape;
+}
+
+static TinyObjShape MakeShape(std::vector<glm::vec3> const& positions, std::vector<uint32_t> const& indices)
+{
+	TinyObjShape shape{};
+	for (auto const& pos : positions) {
+		shape.vertices.push_back(Vertex{ pos, { 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f } });
+	}
+	shape.indices = indices;
+	return shape;
+}
+
+static std::vector<Triangle> GetMeshletTriangles(TinyObjShape const& shape)
+{
+	std::vector<Triangle> triangles;
+	for (auto const& meshlet : shape.meshlets) {
+		for (uint32_t i = 0; i < meshlet.triangleCount; i++) {
+			Triangle triangle;
+			for (int corner = 0; corner < 3; corner++) {
+				auto localIndex = shape.meshletTriangles[meshlet.triangleOffset + 3 * i + corner];
+				triangle[corner] = shape.meshletVertices[meshlet.vertexOffset + localIndex];
+			}
+			triangles.push_back(triangle);
+		}
+	}
+	return triangles;
+}
+
+TEST_CASE(MeshletBuilder, Deterministic)
+{
+	auto first = MakeGrid(40);
+	auto second = MakeGrid(40);
+	MeshletBuilder::Build(first);
+	MeshletBuilder::Build(second);
+
+	TEST_CHECK(first.meshlets.size() == second.meshlets.size());
+	TEST_CHECK(first.meshletVertices == second.meshletVertices);
+	TEST_CHECK(first.meshletTriangles == second.meshletTriangles);
+
+	for (size_t i = 0; i < first.meshlets.size(); i++) {
+		auto const& a = first.meshlets[i];
+		auto const& b = second.meshlets[i];
+		TEST_CHECK(a.vertexOffset == b.vertexOffset && a.triangleOffset == b.triangleOffset);
+		TEST_CHECK(a.vertexCount == b.vertexCount && a.triangleCount == b.triangleCount);
+		TEST_CHECK(a.center == b.center && a.radius == b.radius);
+		TEST_CHECK(a.coneAxis == b.coneAxis && a.coneCutoff == b.coneCutoff);
+	}
+
+	// ujraepites ugyanarra a shape-re is ugyanazt adja
+	auto meshletVertices = first.meshletVertices;
+	MeshletBuilder::Build(first);
+	TEST_CHECK(first.meshletVertices == meshletVertices);
+}
+
+TEST_CASE(MeshletBuilder, Limits)
+{
+	auto shape = MakeGrid(40);
+	MeshletBuilder::Build(shape);
+
+	TEST_CHECK(shape.meshlets.size() > 1);
+	for (auto const& meshlet : shape.meshlets) {
+		TEST_CHECK(meshlet.vertexCount > 0 && meshlet.vertexCount <= MeshletBuilder::maxVertices);
+		TEST_CHECK(meshlet.triangleCount > 0 && meshlet.triangleCount <= MeshletBuilder::maxTriangles);
+	}
+
+	// a sok haromszogu, keves vertex-u legyezo a haromszog limitbe utkozik
+	std::vector<glm::vec3> positions = { { 0.0f, 0.0f, 0.0f } };
+	std::vector<uint32_t> indices;
+	for (uint32_t i = 0; i < 8; i++) {
+		auto angle = glm::radians(45.0f * i);
+		positions.push_back({ std::cos(angle), std::sin(angle), 0.0f });
+	}
+	for (uint32_t repeat = 0; repeat < 40; repeat++) {
+		for (uint32_t i = 0; i < 8; i++) {
+			indices.insert(indices.end(), { 0, 1 + i, 1 + (i + 1) % 8 });
+		}
+	}
+
+	auto fan = MakeShape(positions, indices);
+	MeshletBuilder::Build(fan);
+	TEST_CHECK(fan.meshlets.size() == 3);
+	for (auto const& meshlet : fan.meshlets) {
+		TEST_CHECK(meshlet.triangleCount <= MeshletBuilder::maxTriangles);
+		TEST_CHECK(meshlet.vertexCount == 9);
+	}
+
+	MeshletBuilder::Validate(shape);
+	MeshletBuilder::Validate(fan);
+}
+
+TEST_CASE(MeshletBuilder, EveryTriangleOnce)
+{
+	auto shape = MakeGrid(33);
+	MeshletBuilder::Build(shape);
+
+	std::map<Triangle, int> sourceCounts;
+	for (size_t i = 0; i < shape.indices.size(); i += 3) {
+		sourceCounts[{ shape.indices[i], shape.indices[i + 1], shape.indices[i + 2] }]++;
+	}
+
+	std::map<Triangle, int> meshletCounts;
+	for (auto const& triangle : GetMeshletTriangles(shape)) {
+		meshletCounts[triangle]++;
+	}
+
+	TEST_CHECK(GetMeshletTriangles(shape).size() == shape.indices.size() / 3);
+	TEST_CHECK(sourceCounts == meshletCounts);
+	for (auto const& [triangle, count] : meshletCounts) {
+		TEST_CHECK(count == 1);
+	}
+}
+
+TEST_CASE(MeshletBuilder, BoundingSpheres)
+{
+	// nem sik, hogy a gomb mindharom tengely menten szamitson
+	auto shape = MakeGrid(24);
+	for (auto& vertex : shape.vertices) {
+		vertex.pos.z = std::sin(vertex.pos.x * 0.7f) * std::cos(vertex.pos.y * 0.3f) * 3.0f;
+	}
+	MeshletBuilder::Build(shape);
+
+	for (auto const& meshlet : shape.meshlets) {
+		TEST_CHECK(meshlet.radius > 0.0f);
+		for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+			auto const& pos = shape.vertices[shape.meshletVertices[meshlet.vertexOffset + i]].pos;
+			TEST_CHECK(glm::length(pos - meshlet.center) <= meshlet.radius * (1.0f + 1e-5f));
+		}
+	}
+}
+
+TEST_CASE(MeshletBuilder, NormalConeFlat)
+{
+	// egyetlen +z fele nezo negyzet: a kup tengelye +z, a nyilasszog nulla
+	auto shape = MakeShape({ { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } }, { 0, 1, 2, 0, 2, 3 });
+	MeshletBuilder::Build(shape);
+
+	TEST_CHECK(shape.meshlets.size() == 1);
+	auto const& meshlet = shape.meshlets[0];
+	TEST_CHECK(glm::length(meshlet.coneAxis - glm::vec3(0.0f, 0.0f, 1.0f)) < 1e-5f);
+	TEST_CHECK(meshlet.coneCutoff < 1e-3f);
+
+	TEST_CHECK(meshlet.IsBackfacing({ 0.5f, 0.5f, -5.0f }));
+	TEST_CHECK(meshlet.IsBackfacing({ 3.0f, -2.0f, -5.0f }));
+	TEST_CHECK(!meshlet.IsBackfacing({ 0.5f, 0.5f, 5.0f }));
+	// a sik kozeleben levo kamera a gomb miatt nem dobhatja el
+	TEST_CHECK(!meshlet.IsBackfacing({ 0.5f, 0.5f, -0.2f }));
+	TEST_CHECK(!meshlet.IsBackfacing({ 100.0f, 0.5f, 0.0f }));
+}
+
+TEST_CASE(MeshletBuilder, NormalConeTent)
+{
+	// ket, +z-tol 45 fokkal eldolt lap (sator): a tengely +z, a felnyilasszog 45 fok
+	auto shape = MakeShape({ { -1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, 0.0f }, { -1.0f, 1.0f, 0.0f }, { 0.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 0.0f } },
+		{ 0, 1, 4, 0, 4, 3, 1, 2, 5, 1, 5, 4 });
+	MeshletBuilder::Build(shape);
+
+	TEST_CHECK(shape.meshlets.size() == 1);
+	auto const& meshlet = shape.meshlets[0];
+	TEST_CHECK(glm::length(meshlet.coneAxis - glm::vec3(0.0f, 0.0f, 1.0f)) < 1e-5f);
+	TEST_CHECK(std::abs(meshlet.coneCutoff - std::sqrt(0.5f)) < 1e-4f);
+
+	// pont alulrol mindket lap hatarozottan hatat mutat
+	TEST_CHECK(meshlet.IsBackfacing({ 0.0f, 0.5f, -50.0f }));
+	// 60 fokkal a tengelytol a kup szelen kivul van, az egyik lap mar latszik
+	auto sideDirection = glm::vec3(std::sin(glm::radians(60.0f)), 0.0f, -std::cos(glm::radians(60.0f)));
+	TEST_CHECK(!meshlet.IsBackfacing(meshlet.center + sideDirection * 50.0f));
+	TEST_CHECK(!meshlet.IsBackfacing({ 0.0f, 0.5f, 50.0f }));
+}
+
+TEST_CASE(MeshletBuilder, NormalConeOpposite)
+{
+	// egymasnak hatat fordito lapok: nincs olyan irany, ahonnan mindketto hatat mutat
+	auto shape = MakeShape({ { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 1.0f } },
+		{ 0, 1, 2, 3, 5, 4 });
+	MeshletBuilder::Build(shape);
+
+	TEST_CHECK(shape.meshlets.size() == 1);
+	auto const& meshlet = shape.meshlets[0];
+	TEST_CHECK(meshlet.coneCutoff == 1.0f);
+
+	for (auto const& direction : { glm::vec3(1, 0, 0), glm::vec3(-1, 0, 0), glm::vec3(0, 1, 0), glm::vec3(0, -1, 0), glm::vec3(0, 0, 1), glm::vec3(0, 0, -1) }) {
+		TEST_CHECK(!meshlet.IsBackfacing(meshlet.center + direction * 20.0f));
+	}
+}
+
+TEST_CASE(MeshletBuilder, DegenerateTriangles)
+{
+	// terulet nelkuli haromszogek: a kup nem szukulhet, a lefedes ettol meg teljes
+	auto shape = MakeShape({ { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 2.0f, 0.0f, 0.0f } }, { 0, 1, 2, 1, 1, 2 });
+	MeshletBuilder::Build(shape);
+	MeshletBuilder::Validate(shape);
+
+	TEST_CHECK(shape.meshlets.size() == 1);
+	TEST_CHECK(shape.meshlets[0].coneCutoff == 1.0f);
+	TEST_CHECK(!shape.meshlets[0].IsBackfacing({ 1.0f, 0.0f, -10.0f }));
+}
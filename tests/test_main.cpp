@@ -0,0 +1,8 @@
+#include "test_registry.h"
+
+// usage: minercaftVK-Tests [name prefix], without a prefix every test runs
+int main(int argc, char** argv)
+{
+	std::string prefix = argc > 1 ? argv[1] : "";
+	return theTestRegistry.Run(prefix) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,42 @@
+#include "test_registry.h"
+
+TestRegistry& TestRegistry::Instance()
+{
+	static TestRegistry instance;
+	return instance;
+}
+
+bool TestRegistry::Add(std::string const& name, TestFunc func)
+{
+	tests.emplace_back(name, func);
+	return true;
+}
+
+int TestRegistry::Run(std::string const& prefix)
+{
+	int runCount = 0;
+	int failCount = 0;
+
+	for (auto const& [name, func] : tests) {
+		if (name.rfind(prefix, 0) != 0) continue;
+
+		runCount++;
+		try {
+			func();
+			theLogger.LogInfo("[PASS] {}", name);
+		}
+		catch (std::exception& e) {
+			failCount++;
+			theLogger.LogError("[FAIL] {}: {}", name, e.what());
+		}
+	}
+
+	// egy elirt szuro se fusson le csendben zold eredmennyel
+	if (runCount == 0) {
+		theLogger.LogError("No test matches '{}'", prefix);
+		return 1;
+	}
+
+	theLogger.LogInfo("{} of {} tests passed", runCount - failCount, runCount);
+	return failCount;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "../src/pch.h"
+
+// Minimal self registering test runner, no test framework is needed to build the tests
+struct TestRegistry
+{
+	using TestFunc = void(*)();
+
+	static TestRegistry& Instance();
+
+	bool Add(std::string const& name, TestFunc func);
+	// Runs the tests whose name starts with prefix, returns the number of failed tests
+	int Run(std::string const& prefix);
+
+private:
+	std::vector<std::pair<std::string, TestFunc>> tests;
+};
+
+inline TestRegistry& theTestRegistry = TestRegistry::Instance();
+
+struct TestFailure : std::runtime_error
+{
+	using std::runtime_error::runtime_error;
+};
+
+#define TEST_CASE(suite, name) \
+	static void suite##_##name(); \
+	static bool const suite##_##name##_registered = theTestRegistry.Add(#suite "." #name, suite##_##name); \
+	static void suite##_##name()
+
+// A failed check ends the test case, the message contains the failed expression and its place
+#define TEST_CHECK(condition) \
+	do { \
+		if (!(condition)) throw TestFailure(fmt::format("{}:{}: {}", __FILE__, __LINE__, #condition)); \
+	} while (false)
@@ -0,0 +1,220 @@
+#include "test_registry.h"
+
+#include "../src/texture_compressor.h"
+
+static constexpr std::array<BlockFormat, 3> blockFormats = { BlockFormat::BC1, BlockFormat::BC3, BlockFormat::BC7 };
+
+template<typename Func>
+static MipLevel MakeLevel(glm::ivec2 size, Func&& texelFunc)
+{
+	MipLevel level{ size, std::vector<uint8_t>(size_t{ 4 } * size.x * size.y) };
+	for (int y = 0; y < size.y; y++) {
+		for (int x = 0; x < size.x; x++) {
+			glm::u8vec4 texel = texelFunc(x, y);
+			std::memcpy(level.pixels.data() + 4 * (static_cast<size_t>(y) * size.x + x), &texel, 4);
+		}
+	}
+	return level;
+}
+
+// Encodes and decodes the level, the PSNR is computed over the channels the format stores (BC1 is opaque)
+static double RoundTripPsnr(MipLevel const& level, BlockFormat format)
+{
+	auto compressedLevel = TextureCompressor::CompressLevel(level, format);
+	TEST_CHECK(compressedLevel.size == level.size);
+	TEST_CHECK(compressedLevel.data.size() == TextureCompressor::GetLevelSize(format, level.size));
+
+	auto decoded = TextureCompressor::DecompressLevel(compressedLevel, format);
+	TEST_CHECK(decoded.size == level.size);
+	TEST_CHECK(decoded.pixels.size() == level.pixels.size());
+
+	double squaredErrorSum = 0.0;
+	size_t sampleCount = 0;
+	for (size_t i = 0; i < level.pixels.size(); i++) {
+		if (format == BlockFormat::BC1 && i % 4 == 3) continue;
+
+		auto difference = static_cast<double>(level.pixels[i]) - decoded.pixels[i];
+		squaredErrorSum += difference * difference;
+		sampleCount++;
+	}
+
+	if (squaredErrorSum == 0.0) return std::numeric_limits<double>::infinity();
+	return 10.0 * std::log10(255.0 * 255.0 * sampleCount / squaredErrorSum);
+}
+
+// Largest per channel difference of the decoded level, alpha included
+static int MaxChannelError(MipLevel const& level, BlockFormat format)
+{
+	auto decoded = TextureCompressor::DecompressLevel(TextureCompressor::CompressLevel(level, format), format);
+
+	int maxError = 0;
+	for (size_t i = 0; i < level.pixels.size(); i++) {
+		maxError = std::max(maxError, std::abs(static_cast<int>(level.pixels[i]) - decoded.pixels[i]));
+	}
+	return maxError;
+}
+
+static glm::u8vec4 GradientTexel(int x, int y)
+{
+	return { static_cast<uint8_t>(x * 4), static_cast<uint8_t>(y * 4), static_cast<uint8_t>(128 + x - y), 255 };
+}
+
+TEST_CASE(TextureCompressor, Gradient)
+{
+	auto level = MakeLevel({ 64, 64 }, GradientTexel);
+
+	TEST_CHECK(RoundTripPsnr(level, BlockFormat::BC1) > 35.0);
+	TEST_CHECK(RoundTripPsnr(level, BlockFormat::BC3) > 36.0);
+	TEST_CHECK(RoundTripPsnr(level, BlockFormat::BC7) > 38.0);
+}
+
+TEST_CASE(TextureCompressor, SolidColor)
+{
+	auto level = MakeLevel({ 16, 16 }, [](int, int) { return glm::u8vec4(200, 17, 90, 255); });
+
+	TEST_CHECK(RoundTripPsnr(level, BlockFormat::BC1) > 42.0);
+	TEST_CHECK(RoundTripPsnr(level, BlockFormat::BC3) > 42.0);
+	TEST_CHECK(RoundTripPsnr(level, BlockFormat::BC7) > 48.0);
+
+	// az 5:6:5 kvantalas legfeljebb fel lepest hibazik, a BC7 7+1 bites vegpontjai egyet
+	TEST_CHECK(MaxChannelError(level, BlockFormat::BC1) <= 4);
+	TEST_CHECK(MaxChannelError(level, BlockFormat::BC3) <= 4);
+	TEST_CHECK(MaxChannelError(level, BlockFormat::BC7) <= 1);
+}
+
+TEST_CASE(TextureCompressor, AlphaEdge)
+{
+	// atlos el az atlatszo es az atlatszatlan resz kozott, a blokkok egy resze mindkettot tartalmazza
+	auto level = MakeLevel({ 16, 16 }, [](int x, int y) { return glm::u8vec4(40, 160, 220, x + y < 15 ? 0 : 255); });
+
+	TEST_CHECK(RoundTripPsnr(level, BlockFormat::BC3) > 40.0);
+	TEST_CHECK(RoundTripPsnr(level, BlockFormat::BC7) > 50.0);
+
+	for (auto format : { BlockFormat::BC3, BlockFormat::BC7 }) {
+		auto decoded = TextureCompressor::DecompressLevel(TextureCompressor::CompressLevel(level, format), format);
+		for (size_t i = 3; i < level.pixels.size(); i += 4) {
+			// a BC3 alpha vegpontjai pontosak, a BC7 kozos p-bitje egyet tevedhet
+			TEST_CHECK(std::abs(static_cast<int>(level.pixels[i]) - decoded.pixels[i]) <= (format == BlockFormat::BC3 ? 0 : 1));
+		}
+	}
+}
+
+TEST_CASE(TextureCompressor, Bc7AnchorSwap)
+{
+	// a ket irany kozul az egyikben az elso texel a felso vegponthoz esik, ott az encodernek cserelnie kell
+	std::array<TextureCompressor::Block, 4> blocks;
+	for (int texelIdx = 0; texelIdx < 16; texelIdx++) {
+		auto isWhite = texelIdx == 0 || texelIdx % 3 == 1;
+		auto ramp = static_cast<uint8_t>(255 - texelIdx * 17);
+		blocks[0][texelIdx] = isWhite ? glm::u8vec4(255, 255, 255, 255) : glm::u8vec4(0, 0, 0, 255);
+		blocks[1][texelIdx] = isWhite ? glm::u8vec4(0, 0, 0, 255) : glm::u8vec4(255, 255, 255, 255);
+		blocks[2][texelIdx] = glm::u8vec4(ramp, ramp, ramp, 255);
+		blocks[3][texelIdx] = glm::u8vec4(255 - ramp, 255 - ramp, 255 - ramp, 255);
+	}
+
+	for (size_t blockIdx = 0; blockIdx < blocks.size(); blockIdx++) {
+		std::array<uint8_t, 16> encoded;
+		TextureCompressor::EncodeBc7(blocks[blockIdx], encoded.data());
+		TEST_CHECK((encoded[0] & 0x7f) == 0x40);
+
+		TextureCompressor::Block decoded;
+		TextureCompressor::DecodeBc7(encoded.data(), decoded);
+
+		// a ket szinu blokkban csak a kozos p-bit tevedhet (az alpha), a rampa 16 lepese a 16 sulyhoz kozel esik
+		auto tolerance = blockIdx < 2 ? 1 : 3;
+		for (int texelIdx = 0; texelIdx < 16; texelIdx++) {
+			for (int c = 0; c < 4; c++) {
+				TEST_CHECK(std::abs(static_cast<int>(blocks[blockIdx][texelIdx][c]) - decoded[texelIdx][c]) <= tolerance);
+			}
+		}
+	}
+}
+
+TEST_CASE(TextureCompressor, EdgePadding)
+{
+	for (auto size : { glm::ivec2(13, 7), glm::ivec2(1, 1), glm::ivec2(2, 3), glm::ivec2(5, 17) }) {
+		auto level = MakeLevel(size, [](int x, int y) { return GradientTexel(x * 3, y * 3); });
+
+		// a meredek, ket iranyu gradiens egy vegpontparral csak kozelitheto
+		TEST_CHECK(RoundTripPsnr(level, BlockFormat::BC1) > 28.0);
+		TEST_CHECK(RoundTripPsnr(level, BlockFormat::BC3) > 29.0);
+		TEST_CHECK(RoundTripPsnr(level, BlockFormat::BC7) > 30.0);
+	}
+
+	// a szelso blokk csak a piros es a zold oszlopot latja, a hianyzo texelek az utolso oszlop ismetlesei;
+	// nullakkal feltoltve a fekete harmadik szin rontana a ket szinen
+	auto level = MakeLevel({ 6, 4 }, [](int x, int) {
+		if (x < 4) return glm::u8vec4(0, 0, 255, 255);
+		return x == 4 ? glm::u8vec4(255, 0, 0, 255) : glm::u8vec4(0, 255, 0, 255);
+	});
+
+	for (auto format : blockFormats) {
+		TEST_CHECK(MaxChannelError(level, format) <= 1);
+	}
+}
+
+// Checkerboard, white on the even texels; the block is row major, texel 0 is the top left one
+static TextureCompressor::Block MakeCheckerBlock(glm::u8vec4 const& white, glm::u8vec4 const& black)
+{
+	TextureCompressor::Block block;
+	for (int texelIdx = 0; texelIdx < 16; texelIdx++) {
+		block[texelIdx] = (texelIdx % 4 + texelIdx / 4) % 2 == 0 ? white : black;
+	}
+	return block;
+}
+
+template<size_t Size>
+static void CheckKnownAnswer(BlockFormat format, TextureCompressor::Block const& block, std::array<uint8_t, Size> const& expected, TextureCompressor::Block const& expectedDecoded)
+{
+	TEST_CHECK(TextureCompressor::GetBlockSize(format) == Size);
+
+	std::array<uint8_t, Size> encoded{};
+	TextureCompressor::Block decoded;
+	switch (format) {
+	case BlockFormat::BC1: TextureCompressor::EncodeBc1(block, encoded.data()); TextureCompressor::DecodeBc1(expected.data(), decoded); break;
+	case BlockFormat::BC3: TextureCompressor::EncodeBc3(block, encoded.data()); TextureCompressor::DecodeBc3(expected.data(), decoded); break;
+	case BlockFormat::BC7: TextureCompressor::EncodeBc7(block, encoded.data()); TextureCompressor::DecodeBc7(expected.data(), decoded); break;
+	}
+
+	// a vart bajtok a specifikacio bitkiosztasabol szarmaznak, nem a sajat kodolobol
+	TEST_CHECK(encoded == expected);
+	TEST_CHECK(decoded == expectedDecoded);
+}
+
+TEST_CASE(TextureCompressor, Bc1KnownAnswer)
+{
+	// color0 = 0xffff (feher) > color1 = 0x0000 (fekete): negy szinu mod; 2 bites indexek, soronkent egy bajt, a texel 0 az also bitekben
+	glm::u8vec4 white(255, 255, 255, 255), black(0, 0, 0, 255);
+	auto block = MakeCheckerBlock(white, black);
+	std::array<uint8_t, 8> expected = { 0xff, 0xff, 0x00, 0x00, 0x44, 0x11, 0x44, 0x11 };
+	CheckKnownAnswer(BlockFormat::BC1, block, expected, block);
+
+	// color0 == color1: harom szinu mod, minden index 0
+	glm::u8vec4 red(255, 0, 0, 255);
+	auto solid = MakeCheckerBlock(red, red);
+	std::array<uint8_t, 8> expectedSolid = { 0x00, 0xf8, 0x00, 0xf8, 0x00, 0x00, 0x00, 0x00 };
+	CheckKnownAnswer(BlockFormat::BC1, solid, expectedSolid, solid);
+}
+
+TEST_CASE(TextureCompressor, Bc3KnownAnswer)
+{
+	// feher, a felso ket sor atlatszatlan, az also ket sor atlatszo: alpha0 = 255, alpha1 = 0,
+	// a 3 bites indexek 8 texel 0-ja utan 8 texel 1-e (0x49 0x92 0x24), utana a BC1 szin blokk
+	TextureCompressor::Block block;
+	for (int texelIdx = 0; texelIdx < 16; texelIdx++) {
+		block[texelIdx] = glm::u8vec4(255, 255, 255, texelIdx < 8 ? 255 : 0);
+	}
+
+	std::array<uint8_t, 16> expected = { 0xff, 0x00, 0x00, 0x00, 0x00, 0x49, 0x92, 0x24, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00 };
+	CheckKnownAnswer(BlockFormat::BC3, block, expected, block);
+}
+
+TEST_CASE(TextureCompressor, Bc7KnownAnswer)
+{
+	// mode 6 (7 bit, 0x40), R0 R1 G0 G1 B0 B1 A0 A1 7 bitenkent, P0 P1, 3 bites anchor es 15 darab 4 bites index.
+	// feher = 127 p1 = 255; a fekete alpha-ja 127 p0 = 254, a p1-es valasztas az RGB-t rontana jobban
+	glm::u8vec4 white(255, 255, 255, 255), black(0, 0, 0, 255);
+	auto block = MakeCheckerBlock(white, black);
+	std::array<uint8_t, 16> expected = { 0xc0, 0x3f, 0xe0, 0x0f, 0xf8, 0x03, 0xfe, 0xff, 0xf0, 0xf0, 0x0f, 0x0f, 0xf0, 0xf0, 0x0f, 0x0f };
+	CheckKnownAnswer(BlockFormat::BC7, block, expected, MakeCheckerBlock(white, glm::u8vec4(0, 0, 0, 254)));
+}